@@ -428,6 +428,26 @@ u64 GetSize(FILE* f) {
     return size;
 }
 
+s64 GetModificationTime(const std::string& filename) {
+#ifdef ANDROID
+    // Content URIs don't expose a modification time
+    return 0;
+#else
+    struct stat buf;
+#ifdef _WIN32
+    if (_wstat64(Common::UTF8ToUTF16W(filename).c_str(), &buf) == 0)
+#else
+    if (stat(filename.c_str(), &buf) == 0)
+#endif
+    {
+        return static_cast<s64>(buf.st_mtime);
+    }
+
+    LOG_ERROR(Common_Filesystem, "Stat failed {}: {}", filename, GetLastErrorMsg());
+    return 0;
+#endif
+}
+
 bool CreateEmptyFile(const std::string& filename) {
     LOG_TRACE(Common_Filesystem, "{}", filename);
 
@@ -252,27 +252,41 @@ public:
         color_console_backend.SetEnabled(enabled);
     }
 
-    void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
-                   const char* function, std::string message) {
-        if (!filter.CheckMessage(log_class, log_level)) {
-            return;
-        }
-        Entry new_entry =
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message));
-        if (!regex_filter.empty() &&
-            !boost::regex_search(FormatLogMessage(new_entry), regex_filter)) {
-            return;
-        }
+    bool CanLog(Class log_class, Level log_level) const {
+        return filter.CheckMessage(log_class, log_level);
+    }
+
+    void PushEntry(Entry&& new_entry) {
         if (Settings::values.instant_debug_log.GetValue()) {
+            if (!FinalizeEntry(new_entry)) {
+                return;
+            }
             ForEachBackend([&new_entry](Backend& backend) {
                 backend.Write(new_entry);
                 backend.Flush();
             });
         } else {
-            message_queue.EmplaceWait(new_entry);
+            message_queue.EmplaceWait(std::move(new_entry));
         }
     }
 
+    void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                   const char* function, std::string message) {
+        PushEntry(
+            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+    }
+
+    void PushDeferredEntry(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, std::string_view format,
+                           DeferredFormatter formatter,
+                           const std::array<u8, MaxDeferredArgsSize>& args) {
+        Entry new_entry = CreateEntry(log_class, log_level, filename, line_num, function, {});
+        new_entry.deferred_formatter = formatter;
+        new_entry.format = format;
+        new_entry.deferred_args = args;
+        PushEntry(std::move(new_entry));
+    }
+
 private:
     Impl(const std::string& file_backend_filename, const Filter& filter_)
         : filter{filter_}, file_backend{file_backend_filename} {
@@ -343,6 +357,9 @@ private:
             Common::SetCurrentThreadName("cytrus:Log");
             Entry entry;
             const auto write_logs = [this, &entry]() {
+                if (!FinalizeEntry(entry)) {
+                    return;
+                }
                 ForEachBackend([&entry](Backend& backend) { backend.Write(entry); });
             };
             while (!stop_token.stop_requested()) {
@@ -369,6 +386,18 @@ private:
         ForEachBackend([](Backend& backend) { backend.Flush(); });
     }
 
+    /**
+     * Formats the message of an entry with deferred formatting and applies the regex filter.
+     * Returns false if the entry is filtered out.
+     */
+    bool FinalizeEntry(Entry& entry) const {
+        if (entry.deferred_formatter) {
+            entry.message = entry.deferred_formatter(entry.format, entry.deferred_args.data());
+            entry.deferred_formatter = nullptr;
+        }
+        return regex_filter.empty() || boost::regex_search(FormatLogMessage(entry), regex_filter);
+    }
+
     Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
                       const char* function, std::string&& message) const {
         using std::chrono::duration_cast;
@@ -383,6 +412,9 @@ private:
             .line_num = line_nr,
             .function = function,
             .message = std::move(message),
+            .deferred_formatter = nullptr,
+            .format = {},
+            .deferred_args = {},
         };
     }
 
@@ -484,9 +516,27 @@ void SetColorConsoleBackendEnabled(bool enabled) {
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, fmt::string_view format,
                        const fmt::format_args& args) {
-    if (!initialization_in_progress_suppress_logging) {
-        Impl::Instance().PushEntry(log_class, log_level, filename, line_num, function,
-                                   fmt::vformat(format, args));
+    if (initialization_in_progress_suppress_logging) {
+        return;
+    }
+    auto& instance = Impl::Instance();
+    if (instance.CanLog(log_class, log_level)) {
+        instance.PushEntry(log_class, log_level, filename, line_num, function,
+                           fmt::vformat(format, args));
+    }
+}
+
+void DeferredLogMessageImpl(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function, fmt::string_view format,
+                            DeferredFormatter formatter,
+                            const std::array<u8, MaxDeferredArgsSize>& args) {
+    if (initialization_in_progress_suppress_logging) {
+        return;
+    }
+    auto& instance = Impl::Instance();
+    if (instance.CanLog(log_class, log_level)) {
+        instance.PushDeferredEntry(log_class, log_level, filename, line_num, function,
+                                   {format.data(), format.size()}, formatter, args);
     }
 }
 } // namespace Common::Log
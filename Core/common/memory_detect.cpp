@@ -14,6 +14,11 @@
 #elif defined(__linux__)
 #include <sys/sysinfo.h>
 #endif
+#ifdef __APPLE__
+#include <mach/mach.h>
+#elif defined(__linux__)
+#include <cstdio>
+#endif
 #endif
 
 #include "common/memory_detect.h"
@@ -73,4 +78,28 @@ u64 GetPageSize() {
 #endif
 }
 
+u64 GetProcessResidentMemory() {
+#if defined(__APPLE__)
+    mach_task_basic_info_data_t info{};
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info),
+                  &count) != KERN_SUCCESS) {
+        return 0;
+    }
+    return static_cast<u64>(info.resident_size);
+#elif defined(__linux__)
+    std::FILE* file = std::fopen("/proc/self/statm", "r");
+    if (!file) {
+        return 0;
+    }
+    unsigned long long size_pages{};
+    unsigned long long resident_pages{};
+    const int read = std::fscanf(file, "%llu %llu", &size_pages, &resident_pages);
+    std::fclose(file);
+    return read == 2 ? resident_pages * GetPageSize() : 0;
+#else
+    return 0;
+#endif
+}
+
 } // namespace Common
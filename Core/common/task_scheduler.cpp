@@ -0,0 +1,267 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <fmt/format.h>
+#include "common/task_scheduler.h"
+#include "common/thread.h"
+
+namespace Common {
+
+namespace {
+
+constexpr std::size_t NoWorker = std::numeric_limits<std::size_t>::max();
+
+thread_local const TaskScheduler* current_scheduler = nullptr;
+thread_local std::size_t current_worker = NoWorker;
+
+} // Anonymous namespace
+
+TaskScheduler::TaskScheduler(std::size_t num_workers) {
+    workers.reserve(num_workers);
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        workers[i]->thread = std::jthread(
+            [this, i](std::stop_token stop_token) { WorkerLoop(stop_token, i); });
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    for (auto& worker : workers) {
+        worker->thread.request_stop();
+    }
+    {
+        std::scoped_lock lock{sleep_mutex};
+        sleep_cv.notify_all();
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+
+    // Tasks that never ran are dropped, their groups are gone by now.
+    for (auto& worker : workers) {
+        while (Task* task = worker->deque.Steal()) {
+            delete task;
+        }
+    }
+    for (auto& queue : injected) {
+        for (Task* task : queue) {
+            delete task;
+        }
+        queue.clear();
+    }
+}
+
+TaskScheduler& TaskScheduler::Instance() {
+    static TaskScheduler instance{std::max(std::thread::hardware_concurrency(), 2U) - 1};
+    return instance;
+}
+
+void TaskScheduler::Schedule(std::unique_ptr<Task> task) {
+    // Count the task before publishing it, so sleeping workers never miss it.
+    num_queued.fetch_add(1);
+    Task* const raw_task = task.release();
+    const bool is_local = IsWorkerThread() && raw_task->priority != TaskPriority::High &&
+                          workers[current_worker]->deque.Push(raw_task);
+    if (!is_local) {
+        std::scoped_lock lock{injected_mutex};
+        injected[static_cast<std::size_t>(raw_task->priority)].push_back(raw_task);
+    }
+    if (num_sleeping.load() > 0) {
+        std::scoped_lock lock{sleep_mutex};
+        sleep_cv.notify_one();
+    }
+}
+
+bool TaskScheduler::TryRunOne() {
+    Task* const task = FindTask(IsWorkerThread() ? current_worker : NoWorker);
+    if (!task) {
+        return false;
+    }
+    Execute(task);
+    return true;
+}
+
+bool TaskScheduler::IsWorkerThread() const {
+    return current_scheduler == this;
+}
+
+void TaskScheduler::WorkerLoop(std::stop_token stop_token, std::size_t index) {
+    const std::string name = fmt::format("cytrus:Worker{}", index);
+    Common::SetCurrentThreadName(name.c_str());
+    current_scheduler = this;
+    current_worker = index;
+
+    while (!stop_token.stop_requested()) {
+        if (Task* const task = FindTask(index)) {
+            Execute(task);
+            continue;
+        }
+        std::unique_lock lock{sleep_mutex};
+        num_sleeping.fetch_add(1);
+        Common::CondvarWait(sleep_cv, lock, stop_token, [this] { return num_queued.load() > 0; });
+        num_sleeping.fetch_sub(1);
+    }
+}
+
+TaskScheduler::Task* TaskScheduler::FindTask(std::size_t index) {
+    Task* task = nullptr;
+    if (index != NoWorker) {
+        task = workers[index]->deque.Pop();
+    }
+    if (!task) {
+        task = PopInjected(TaskPriority::High);
+    }
+    if (!task) {
+        task = StealFrom(index == NoWorker ? 0 : index + 1);
+    }
+    if (!task) {
+        task = PopInjected(TaskPriority::Normal);
+    }
+    if (!task) {
+        task = PopInjected(TaskPriority::Low);
+    }
+    if (task) {
+        num_queued.fetch_sub(1);
+    }
+    return task;
+}
+
+TaskScheduler::Task* TaskScheduler::PopInjected(TaskPriority priority) {
+    auto& queue = injected[static_cast<std::size_t>(priority)];
+    std::scoped_lock lock{injected_mutex};
+    if (queue.empty()) {
+        return nullptr;
+    }
+    Task* const task = queue.front();
+    queue.pop_front();
+    return task;
+}
+
+TaskScheduler::Task* TaskScheduler::StealFrom(std::size_t first) {
+    const std::size_t num_workers = workers.size();
+    for (std::size_t i = 0; i < num_workers; ++i) {
+        const std::size_t victim = (first + i) % num_workers;
+        if (victim == current_worker && IsWorkerThread()) {
+            continue;
+        }
+        if (Task* const task = workers[victim]->deque.Steal()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+void TaskScheduler::Execute(Task* task) {
+    TaskGroup* const group = task->group;
+    {
+        const std::unique_ptr<Task> owned{task};
+        if (!group->cancelled.load(std::memory_order_relaxed)) {
+            owned->func();
+        }
+    }
+    group->OnTaskFinished();
+}
+
+TaskGroup::TaskGroup(std::string_view name_, std::size_t max_concurrency_,
+                     TaskPriority priority_, TaskScheduler& scheduler_)
+    : scheduler{scheduler_}, name{name_},
+      max_concurrency{std::clamp<std::size_t>(max_concurrency_, 1, scheduler_.NumWorkers())},
+      priority{priority_} {}
+
+TaskGroup::~TaskGroup() {
+    cancelled = true;
+    {
+        std::scoped_lock lock{mutex};
+        outstanding -= pending.size();
+        pending.clear();
+    }
+    Wait();
+}
+
+void TaskGroup::QueueWork(UniqueFunction<void> func) {
+    QueueWork(std::move(func), priority);
+}
+
+void TaskGroup::QueueWork(UniqueFunction<void> func, TaskPriority task_priority) {
+    auto task = std::make_unique<TaskScheduler::Task>(
+        TaskScheduler::Task{std::move(func), this, task_priority});
+    {
+        std::scoped_lock lock{mutex};
+        ++outstanding;
+        if (running >= max_concurrency) {
+            pending.push_back(std::move(task));
+            return;
+        }
+        ++running;
+    }
+    scheduler.Schedule(std::move(task));
+}
+
+void TaskGroup::Wait() {
+    if (scheduler.IsWorkerThread()) {
+        // Blocking a worker could starve the tasks we wait on, help run them instead.
+        while (true) {
+            {
+                std::scoped_lock lock{mutex};
+                if (outstanding == 0) {
+                    return;
+                }
+            }
+            if (!scheduler.TryRunOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    std::unique_lock lock{mutex};
+    idle_cv.wait(lock, [this] { return outstanding == 0; });
+}
+
+bool TaskGroup::WaitFor(std::chrono::milliseconds timeout) {
+    if (scheduler.IsWorkerThread()) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (true) {
+            {
+                std::scoped_lock lock{mutex};
+                if (outstanding == 0) {
+                    return true;
+                }
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            if (!scheduler.TryRunOne()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+    std::unique_lock lock{mutex};
+    return idle_cv.wait_for(lock, timeout, [this] { return outstanding == 0; });
+}
+
+void TaskGroup::OnTaskFinished() {
+    std::unique_ptr<TaskScheduler::Task> next;
+    {
+        std::scoped_lock lock{mutex};
+        --outstanding;
+        if (!pending.empty()) {
+            next = std::move(pending.front());
+            pending.pop_front();
+        } else {
+            --running;
+        }
+        if (outstanding == 0) {
+            idle_cv.notify_all();
+        }
+    }
+    if (next) {
+        scheduler.Schedule(std::move(next));
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,271 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+#include <fmt/format.h>
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+#include "common/file_util.h"
+#include "common/logging/log.h"
+#include "common/microprofile.h"
+#include "common/tracing.h"
+
+namespace Common::Tracing {
+
+namespace Detail {
+std::atomic_bool enabled{false};
+} // namespace Detail
+
+namespace {
+
+enum class Phase : u8 {
+    Begin,
+    End,
+};
+
+struct Event {
+    const char* category;
+    const char* name;
+    s64 timestamp;
+    Phase phase;
+};
+
+constexpr std::size_t EventsPerChunk = 16384;
+constexpr std::size_t MaxChunksPerThread = 256;
+
+struct Chunk {
+    std::array<Event, EventsPerChunk> events;
+};
+
+/**
+ * Events of one thread. Only the owning thread writes to the buffer, the events are published to
+ * the thread stopping the session by the release store of the event count.
+ */
+struct ThreadBuffer {
+    std::array<std::atomic<Chunk*>, MaxChunksPerThread> chunks{};
+    std::atomic<std::size_t> size{};
+    std::atomic<u32> session{};
+    std::size_t dropped{};
+    u32 thread_id{};
+    std::string thread_name;
+
+    ~ThreadBuffer() {
+        for (auto& chunk : chunks) {
+            delete chunk.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+struct State {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::unordered_set<std::string> names;
+    std::atomic<u32> session{};
+    std::chrono::steady_clock::time_point start_time;
+};
+
+State& GetState() {
+    static State state;
+    return state;
+}
+
+thread_local ThreadBuffer* current_buffer = nullptr;
+
+ThreadBuffer& RegisterThread() {
+    auto buffer = std::make_unique<ThreadBuffer>();
+#ifndef _WIN32
+    std::array<char, 64> name{};
+    if (pthread_getname_np(pthread_self(), name.data(), name.size()) == 0 && name[0] != '\0') {
+        buffer->thread_name = name.data();
+    }
+#endif
+
+    State& state = GetState();
+    std::scoped_lock lock{state.mutex};
+    buffer->thread_id = static_cast<u32>(state.buffers.size() + 1);
+    if (buffer->thread_name.empty()) {
+        buffer->thread_name = fmt::format("Thread {}", buffer->thread_id);
+    }
+    current_buffer = buffer.get();
+    state.buffers.push_back(std::move(buffer));
+    return *current_buffer;
+}
+
+void Record(const char* category, const char* name, Phase phase) noexcept {
+    State& state = GetState();
+    const s64 timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count();
+    ThreadBuffer& buffer = current_buffer ? *current_buffer : RegisterThread();
+
+    // Events of a previous session are dropped lazily by their owner.
+    const u32 session = state.session.load(std::memory_order_acquire);
+    if (buffer.session.load(std::memory_order_relaxed) != session) {
+        buffer.size.store(0, std::memory_order_relaxed);
+        buffer.dropped = 0;
+        buffer.session.store(session, std::memory_order_release);
+    }
+
+    const std::size_t index = buffer.size.load(std::memory_order_relaxed);
+    const std::size_t chunk_index = index / EventsPerChunk;
+    if (chunk_index >= MaxChunksPerThread) [[unlikely]] {
+        buffer.dropped++;
+        return;
+    }
+    Chunk* chunk = buffer.chunks[chunk_index].load(std::memory_order_relaxed);
+    if (!chunk) [[unlikely]] {
+        chunk = new Chunk;
+        buffer.chunks[chunk_index].store(chunk, std::memory_order_relaxed);
+    }
+    chunk->events[index % EventsPerChunk] = {category, name, timestamp, phase};
+    buffer.size.store(index + 1, std::memory_order_release);
+}
+
+void AppendEscaped(fmt::memory_buffer& out, std::string_view text) {
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out.push_back('\\');
+        }
+        if (static_cast<unsigned char>(c) < 0x20) {
+            continue;
+        }
+        out.push_back(c);
+    }
+}
+
+} // Anonymous namespace
+
+void Start() {
+    State& state = GetState();
+    std::scoped_lock lock{state.mutex};
+    if (Detail::enabled) {
+        return;
+    }
+    state.start_time = std::chrono::steady_clock::now();
+    state.session.fetch_add(1, std::memory_order_release);
+    Detail::enabled = true;
+    LOG_INFO(Common, "Started recording trace");
+}
+
+bool Stop(const std::string& path) {
+    State& state = GetState();
+    std::scoped_lock lock{state.mutex};
+    if (!Detail::enabled.exchange(false)) {
+        return false;
+    }
+
+    FileUtil::IOFile file{path, "w"};
+    if (!file.IsOpen()) {
+        LOG_ERROR(Common, "Unable to open trace file {}", path);
+        return false;
+    }
+
+    const s64 start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               state.start_time.time_since_epoch())
+                               .count();
+    const u32 session = state.session.load(std::memory_order_relaxed);
+
+    constexpr std::size_t FlushThreshold = 1 << 20;
+    fmt::memory_buffer out;
+    bool first = true;
+    const auto separator = [&] {
+        if (!first) {
+            out.push_back(',');
+        }
+        out.push_back('\n');
+        first = false;
+    };
+    const auto flush = [&](bool force) {
+        if (force || out.size() >= FlushThreshold) {
+            file.WriteBytes(out.data(), out.size());
+            out.clear();
+        }
+    };
+
+    fmt::format_to(std::back_inserter(out), "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+    std::size_t num_events = 0;
+    std::size_t num_dropped = 0;
+    for (const auto& buffer : state.buffers) {
+        if (buffer->session.load(std::memory_order_acquire) != session) {
+            continue;
+        }
+        const std::size_t size = buffer->size.load(std::memory_order_acquire);
+        separator();
+        fmt::format_to(std::back_inserter(out),
+                       "{{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":{},"
+                       "\"args\":{{\"name\":\"",
+                       buffer->thread_id);
+        AppendEscaped(out, buffer->thread_name);
+        fmt::format_to(std::back_inserter(out), "\"}}}}");
+
+        for (std::size_t i = 0; i < size; i++) {
+            const Chunk* chunk =
+                buffer->chunks[i / EventsPerChunk].load(std::memory_order_relaxed);
+            const Event& event = chunk->events[i % EventsPerChunk];
+            const s64 timestamp = event.timestamp - start_time;
+            if (timestamp < 0) {
+                continue;
+            }
+            separator();
+            if (event.phase == Phase::Begin) {
+                fmt::format_to(std::back_inserter(out), "{{\"ph\":\"B\",\"cat\":\"");
+                AppendEscaped(out, event.category);
+                fmt::format_to(std::back_inserter(out), "\",\"name\":\"");
+                AppendEscaped(out, event.name);
+                out.push_back('"');
+            } else {
+                fmt::format_to(std::back_inserter(out), "{{\"ph\":\"E\"");
+            }
+            fmt::format_to(std::back_inserter(out), ",\"pid\":1,\"tid\":{},\"ts\":{}.{:03}}}",
+                           buffer->thread_id, timestamp / 1000, timestamp % 1000);
+            flush(false);
+        }
+        num_events += size;
+        num_dropped += buffer->dropped;
+    }
+    fmt::format_to(std::back_inserter(out), "\n]}}\n");
+    flush(true);
+
+    if (num_dropped > 0) {
+        LOG_WARNING(Common, "Dropped {} trace events, the per thread buffers are full",
+                    num_dropped);
+    }
+    LOG_INFO(Common, "Wrote {} trace events to {}", num_events, path);
+    return file.IsGood();
+}
+
+const char* InternName(std::string_view name) {
+    State& state = GetState();
+    std::scoped_lock lock{state.mutex};
+    return state.names.emplace(name).first->c_str();
+}
+
+void BeginEvent(const char* category, const char* name) noexcept {
+    Record(category, name, Phase::Begin);
+}
+
+void BeginEvent(u64 microprofile_token) noexcept {
+#if MICROPROFILE_ENABLED
+    // Timer and group names live in the microprofile state for the lifetime of the process.
+    const MicroProfile* const profile = MicroProfileGet();
+    const u16 timer = MicroProfileGetTimerIndex(microprofile_token);
+    Record(profile->GroupInfo[profile->TimerToGroup[timer]].pName, profile->TimerInfo[timer].pName,
+           Phase::Begin);
+#else
+    Record("MicroProfile", "Scope", Phase::Begin);
+#endif
+}
+
+void EndEvent() noexcept {
+    Record(nullptr, nullptr, Phase::End);
+}
+
+} // namespace Common::Tracing
@@ -0,0 +1,111 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <cstring>
+#include <vector>
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/common_types.h"
+#include "common/logging/log.h"
+#include "common/memory_detect.h"
+#include "common/virtual_buffer.h"
+
+namespace Common {
+
+void* AllocateMemoryPages(std::size_t size) noexcept {
+    if (size == 0) {
+        return nullptr;
+    }
+#ifdef _WIN32
+    void* base = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+#else
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        base = nullptr;
+    }
+#endif
+    ASSERT_MSG(base, "Failed to reserve {} bytes of host memory", size);
+    return base;
+}
+
+void FreeMemoryPages(void* base, [[maybe_unused]] std::size_t size) noexcept {
+    if (!base) {
+        return;
+    }
+#ifdef _WIN32
+    VirtualFree(base, 0, MEM_RELEASE);
+#else
+    munmap(base, size);
+#endif
+}
+
+void DecommitMemoryPages(void* base, std::size_t size) noexcept {
+    const std::size_t page_size = static_cast<std::size_t>(GetPageSize());
+    const uintptr_t start = reinterpret_cast<uintptr_t>(base);
+    const uintptr_t end = start + size;
+    const uintptr_t page_start = AlignUp(start, page_size);
+    const uintptr_t page_end = AlignDown(end, page_size);
+    if (page_start >= page_end) {
+        std::memset(base, 0, size);
+        return;
+    }
+
+    std::memset(base, 0, page_start - start);
+    std::memset(reinterpret_cast<void*>(page_end), 0, end - page_end);
+
+    void* const pages = reinterpret_cast<void*>(page_start);
+    const std::size_t pages_size = page_end - page_start;
+#ifdef _WIN32
+    VirtualFree(pages, pages_size, MEM_DECOMMIT);
+    VirtualAlloc(pages, pages_size, MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+    // Private anonymous pages read as zero after MADV_DONTNEED.
+    if (madvise(pages, pages_size, MADV_DONTNEED) != 0) {
+        std::memset(pages, 0, pages_size);
+    }
+#else
+    // Other hosts do not guarantee zeroed pages after madvise, map fresh pages over the range.
+    if (mmap(pages, pages_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+             -1, 0) == MAP_FAILED) {
+        std::memset(pages, 0, pages_size);
+    }
+#endif
+}
+
+std::size_t GetResidentMemory(const void* base, std::size_t size) noexcept {
+#ifdef _WIN32
+    return 0;
+#else
+    if (!base || size == 0) {
+        return 0;
+    }
+    const std::size_t page_size = static_cast<std::size_t>(GetPageSize());
+    const uintptr_t start = AlignDown(reinterpret_cast<uintptr_t>(base), page_size);
+    const uintptr_t end = AlignUp(reinterpret_cast<uintptr_t>(base) + size, page_size);
+    std::vector<unsigned char> residency((end - start) / page_size);
+#ifdef __APPLE__
+    const int result = mincore(reinterpret_cast<caddr_t>(start), end - start,
+                               reinterpret_cast<char*>(residency.data()));
+#else
+    const int result = mincore(reinterpret_cast<void*>(start), end - start, residency.data());
+#endif
+    if (result != 0) {
+        LOG_WARNING(Common_Memory, "Unable to query the residency of host memory");
+        return 0;
+    }
+    std::size_t resident_pages = 0;
+    for (const unsigned char page : residency) {
+        resident_pages += page & 1;
+    }
+    return resident_pages * page_size;
+#endif
+}
+
+} // namespace Common
@@ -0,0 +1,428 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+// Implementation of the XXH3 64-bit hash by Yann Collet.
+// See https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md for the specification.
+
+#include <array>
+#include <cstring>
+#include "common/arch.h"
+#include "common/xxh3.h"
+
+#if CYTRUS_ARCH(x86_64)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif CYTRUS_ARCH(arm64)
+#include <arm_neon.h>
+#endif
+
+namespace Common {
+
+namespace {
+
+constexpr u64 PRIME32_1 = 0x9E3779B1U;
+constexpr u64 PRIME32_2 = 0x85EBCA77U;
+constexpr u64 PRIME32_3 = 0xC2B2AE3DU;
+constexpr u64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr u64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr u64 PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr u64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr u64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+constexpr u64 PRIME_MX1 = 0x165667919E3779F9ULL;
+constexpr u64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr std::size_t STRIPE_LEN = 64;
+constexpr std::size_t SECRET_CONSUME_RATE = 8;
+constexpr std::size_t ACC_NB = STRIPE_LEN / sizeof(u64);
+constexpr std::size_t SECRET_SIZE_MIN = 136;
+constexpr std::size_t SECRET_LASTACC_START = 7;
+constexpr std::size_t SECRET_MERGEACCS_START = 11;
+constexpr std::size_t MIDSIZE_MAX = 240;
+constexpr std::size_t MIDSIZE_STARTOFFSET = 3;
+constexpr std::size_t MIDSIZE_LASTOFFSET = 17;
+
+alignas(64) constexpr std::array<u8, 192> kSecret = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+// The reads below assume a little-endian host, like the rest of the emulator.
+u32 Read32(const u8* ptr) {
+    u32 value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+u64 Read64(const u8* ptr) {
+    u64 value;
+    std::memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+u64 Rotl64(u64 value, int amount) {
+    return (value << amount) | (value >> (64 - amount));
+}
+
+u32 Swap32(u32 value) {
+    return ((value << 24) & 0xff000000) | ((value << 8) & 0x00ff0000) |
+           ((value >> 8) & 0x0000ff00) | ((value >> 24) & 0x000000ff);
+}
+
+u64 Swap64(u64 value) {
+    return (static_cast<u64>(Swap32(static_cast<u32>(value))) << 32) |
+           Swap32(static_cast<u32>(value >> 32));
+}
+
+u64 Mul128Fold64(u64 lhs, u64 rhs) {
+#if defined(_MSC_VER) && CYTRUS_ARCH(x86_64)
+    u64 high;
+    const u64 low = _umul128(lhs, rhs, &high);
+    return low ^ high;
+#elif defined(_MSC_VER) && CYTRUS_ARCH(arm64)
+    return (lhs * rhs) ^ __umulh(lhs, rhs);
+#else
+    const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+    return static_cast<u64>(product) ^ static_cast<u64>(product >> 64);
+#endif
+}
+
+u64 XXH64Avalanche(u64 hash) {
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+u64 Avalanche(u64 hash) {
+    hash ^= hash >> 37;
+    hash *= PRIME_MX1;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+u64 Rrmxmx(u64 hash, u64 len) {
+    hash ^= Rotl64(hash, 49) ^ Rotl64(hash, 24);
+    hash *= PRIME_MX2;
+    hash ^= (hash >> 35) + len;
+    hash *= PRIME_MX2;
+    return hash ^ (hash >> 28);
+}
+
+u64 Mix16B(const u8* input, const u8* secret) {
+    return Mul128Fold64(Read64(input) ^ Read64(secret), Read64(input + 8) ^ Read64(secret + 8));
+}
+
+u64 Len1To3(const u8* input, std::size_t len) {
+    const u32 c1 = input[0];
+    const u32 c2 = input[len >> 1];
+    const u32 c3 = input[len - 1];
+    const u32 combined =
+        (c1 << 16) | (c2 << 24) | (c3 << 0) | (static_cast<u32>(len) << 8);
+    const u64 bitflip = Read32(kSecret.data()) ^ Read32(kSecret.data() + 4);
+    return XXH64Avalanche(static_cast<u64>(combined) ^ bitflip);
+}
+
+u64 Len4To8(const u8* input, std::size_t len) {
+    const u32 input1 = Read32(input);
+    const u32 input2 = Read32(input + len - 4);
+    const u64 bitflip = Read64(kSecret.data() + 8) ^ Read64(kSecret.data() + 16);
+    const u64 input64 = input2 + (static_cast<u64>(input1) << 32);
+    return Rrmxmx(input64 ^ bitflip, len);
+}
+
+u64 Len9To16(const u8* input, std::size_t len) {
+    const u64 bitflip1 = Read64(kSecret.data() + 24) ^ Read64(kSecret.data() + 32);
+    const u64 bitflip2 = Read64(kSecret.data() + 40) ^ Read64(kSecret.data() + 48);
+    const u64 input_lo = Read64(input) ^ bitflip1;
+    const u64 input_hi = Read64(input + len - 8) ^ bitflip2;
+    const u64 acc = len + Swap64(input_lo) + input_hi + Mul128Fold64(input_lo, input_hi);
+    return Avalanche(acc);
+}
+
+u64 Len0To16(const u8* input, std::size_t len) {
+    if (len > 8) {
+        return Len9To16(input, len);
+    }
+    if (len >= 4) {
+        return Len4To8(input, len);
+    }
+    if (len > 0) {
+        return Len1To3(input, len);
+    }
+    return XXH64Avalanche(Read64(kSecret.data() + 56) ^ Read64(kSecret.data() + 64));
+}
+
+u64 Len17To128(const u8* input, std::size_t len) {
+    const u8* secret = kSecret.data();
+    u64 acc = len * PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += Mix16B(input + 48, secret + 96);
+                acc += Mix16B(input + len - 64, secret + 112);
+            }
+            acc += Mix16B(input + 32, secret + 64);
+            acc += Mix16B(input + len - 48, secret + 80);
+        }
+        acc += Mix16B(input + 16, secret + 32);
+        acc += Mix16B(input + len - 32, secret + 48);
+    }
+    acc += Mix16B(input + 0, secret + 0);
+    acc += Mix16B(input + len - 16, secret + 16);
+    return Avalanche(acc);
+}
+
+u64 Len129To240(const u8* input, std::size_t len) {
+    const u8* secret = kSecret.data();
+    const std::size_t num_rounds = len / 16;
+    u64 acc = len * PRIME64_1;
+    for (std::size_t i = 0; i < 8; i++) {
+        acc += Mix16B(input + 16 * i, secret + 16 * i);
+    }
+    u64 acc_end = Mix16B(input + len - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET);
+    acc = Avalanche(acc);
+    for (std::size_t i = 8; i < num_rounds; i++) {
+        acc_end += Mix16B(input + 16 * i, secret + 16 * (i - 8) + MIDSIZE_STARTOFFSET);
+    }
+    return Avalanche(acc + acc_end);
+}
+
+void Accumulate512Scalar(u64* acc, const u8* input, const u8* secret) {
+    for (std::size_t i = 0; i < ACC_NB; i++) {
+        const u64 data_val = Read64(input + 8 * i);
+        const u64 data_key = data_val ^ Read64(secret + 8 * i);
+        acc[i ^ 1] += data_val;
+        acc[i] += (data_key & 0xFFFFFFFF) * (data_key >> 32);
+    }
+}
+
+void ScrambleScalar(u64* acc, const u8* secret) {
+    for (std::size_t i = 0; i < ACC_NB; i++) {
+        u64 acc64 = acc[i];
+        acc64 ^= acc64 >> 47;
+        acc64 ^= Read64(secret + 8 * i);
+        acc64 *= PRIME32_1;
+        acc[i] = acc64;
+    }
+}
+
+#if CYTRUS_ARCH(x86_64)
+
+void Accumulate512SSE2(u64* acc, const u8* input, const u8* secret) {
+    auto* const xacc = reinterpret_cast<__m128i*>(acc);
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(__m128i); i++) {
+        const __m128i data_vec =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+        const __m128i key_vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        const __m128i data_key = _mm_xor_si128(data_vec, key_vec);
+        const __m128i data_key_lo = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i product = _mm_mul_epu32(data_key, data_key_lo);
+        const __m128i data_swap = _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m128i sum = _mm_add_epi64(xacc[i], data_swap);
+        xacc[i] = _mm_add_epi64(product, sum);
+    }
+}
+
+void ScrambleSSE2(u64* acc, const u8* secret) {
+    auto* const xacc = reinterpret_cast<__m128i*>(acc);
+    const __m128i prime32 = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(__m128i); i++) {
+        const __m128i acc_vec = xacc[i];
+        const __m128i data_vec = _mm_xor_si128(acc_vec, _mm_srli_epi64(acc_vec, 47));
+        const __m128i key_vec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i);
+        const __m128i data_key = _mm_xor_si128(data_vec, key_vec);
+        const __m128i data_key_hi = _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i prod_lo = _mm_mul_epu32(data_key, prime32);
+        const __m128i prod_hi = _mm_mul_epu32(data_key_hi, prime32);
+        xacc[i] = _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32));
+    }
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define XXH3_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define XXH3_TARGET_AVX2
+#endif
+
+XXH3_TARGET_AVX2 void Accumulate512AVX2(u64* acc, const u8* input, const u8* secret) {
+    auto* const xacc = reinterpret_cast<__m256i*>(acc);
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(__m256i); i++) {
+        const __m256i data_vec =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input) + i);
+        const __m256i key_vec =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i);
+        const __m256i data_key = _mm256_xor_si256(data_vec, key_vec);
+        const __m256i data_key_lo = _mm256_srli_epi64(data_key, 32);
+        const __m256i product = _mm256_mul_epu32(data_key, data_key_lo);
+        const __m256i data_swap = _mm256_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2));
+        const __m256i sum = _mm256_add_epi64(xacc[i], data_swap);
+        xacc[i] = _mm256_add_epi64(product, sum);
+    }
+}
+
+XXH3_TARGET_AVX2 void ScrambleAVX2(u64* acc, const u8* secret) {
+    auto* const xacc = reinterpret_cast<__m256i*>(acc);
+    const __m256i prime32 = _mm256_set1_epi32(static_cast<int>(PRIME32_1));
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(__m256i); i++) {
+        const __m256i acc_vec = xacc[i];
+        const __m256i data_vec = _mm256_xor_si256(acc_vec, _mm256_srli_epi64(acc_vec, 47));
+        const __m256i key_vec =
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i);
+        const __m256i data_key = _mm256_xor_si256(data_vec, key_vec);
+        const __m256i data_key_hi = _mm256_srli_epi64(data_key, 32);
+        const __m256i prod_lo = _mm256_mul_epu32(data_key, prime32);
+        const __m256i prod_hi = _mm256_mul_epu32(data_key_hi, prime32);
+        xacc[i] = _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32));
+    }
+}
+
+#undef XXH3_TARGET_AVX2
+
+bool HostSupportsAVX2() {
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    const bool has_osxsave = (regs[2] & (1 << 27)) != 0;
+    const bool has_avx = (regs[2] & (1 << 28)) != 0;
+    if (!has_osxsave || !has_avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#elif CYTRUS_ARCH(arm64)
+
+void Accumulate512NEON(u64* acc, const u8* input, const u8* secret) {
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(uint64x2_t); i++) {
+        const uint64x2_t data_vec = vreinterpretq_u64_u8(vld1q_u8(input + 16 * i));
+        const uint64x2_t key_vec = vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i));
+        const uint64x2_t data_key = veorq_u64(data_vec, key_vec);
+        const uint32x2_t data_key_lo = vmovn_u64(data_key);
+        const uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
+        const uint64x2_t data_swap = vextq_u64(data_vec, data_vec, 1);
+        uint64x2_t acc_vec = vld1q_u64(acc + 2 * i);
+        acc_vec = vaddq_u64(acc_vec, data_swap);
+        acc_vec = vmlal_u32(acc_vec, data_key_lo, data_key_hi);
+        vst1q_u64(acc + 2 * i, acc_vec);
+    }
+}
+
+void ScrambleNEON(u64* acc, const u8* secret) {
+    const uint32x2_t prime32 = vdup_n_u32(static_cast<u32>(PRIME32_1));
+    for (std::size_t i = 0; i < STRIPE_LEN / sizeof(uint64x2_t); i++) {
+        uint64x2_t acc_vec = vld1q_u64(acc + 2 * i);
+        acc_vec = veorq_u64(acc_vec, vshrq_n_u64(acc_vec, 47));
+        const uint64x2_t key_vec = vreinterpretq_u64_u8(vld1q_u8(secret + 16 * i));
+        const uint64x2_t data_key = veorq_u64(acc_vec, key_vec);
+        const uint32x2_t data_key_lo = vmovn_u64(data_key);
+        const uint32x2_t data_key_hi = vshrn_n_u64(data_key, 32);
+        const uint64x2_t prod_hi = vshlq_n_u64(vmull_u32(data_key_hi, prime32), 32);
+        vst1q_u64(acc + 2 * i, vmlal_u32(prod_hi, data_key_lo, prime32));
+    }
+}
+
+#endif
+
+using Accumulate512Func = void (*)(u64* acc, const u8* input, const u8* secret);
+using ScrambleFunc = void (*)(u64* acc, const u8* secret);
+
+struct LongHashBackend {
+    Accumulate512Func accumulate;
+    ScrambleFunc scramble;
+};
+
+LongHashBackend SelectBackend() {
+#if CYTRUS_ARCH(x86_64)
+    if (HostSupportsAVX2()) {
+        return {Accumulate512AVX2, ScrambleAVX2};
+    }
+    return {Accumulate512SSE2, ScrambleSSE2};
+#elif CYTRUS_ARCH(arm64)
+    return {Accumulate512NEON, ScrambleNEON};
+#else
+    return {Accumulate512Scalar, ScrambleScalar};
+#endif
+}
+
+const LongHashBackend backend = SelectBackend();
+
+u64 HashLong(const u8* input, std::size_t len) {
+    const u8* secret = kSecret.data();
+    constexpr std::size_t secret_size = kSecret.size();
+    constexpr std::size_t stripes_per_block = (secret_size - STRIPE_LEN) / SECRET_CONSUME_RATE;
+    constexpr std::size_t block_len = STRIPE_LEN * stripes_per_block;
+
+    alignas(32) u64 acc[ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+                                   PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+    const auto accumulate = backend.accumulate;
+    const std::size_t num_blocks = (len - 1) / block_len;
+    for (std::size_t n = 0; n < num_blocks; n++) {
+        const u8* block = input + n * block_len;
+        for (std::size_t s = 0; s < stripes_per_block; s++) {
+            accumulate(acc, block + s * STRIPE_LEN, secret + s * SECRET_CONSUME_RATE);
+        }
+        backend.scramble(acc, secret + secret_size - STRIPE_LEN);
+    }
+
+    // Last partial block
+    const std::size_t num_stripes = ((len - 1) - (block_len * num_blocks)) / STRIPE_LEN;
+    const u8* block = input + num_blocks * block_len;
+    for (std::size_t s = 0; s < num_stripes; s++) {
+        accumulate(acc, block + s * STRIPE_LEN, secret + s * SECRET_CONSUME_RATE);
+    }
+
+    // Last stripe
+    accumulate(acc, input + len - STRIPE_LEN,
+               secret + secret_size - STRIPE_LEN - SECRET_LASTACC_START);
+
+    // Merge accumulators
+    const u8* merge_secret = secret + SECRET_MERGEACCS_START;
+    u64 result = len * PRIME64_1;
+    for (std::size_t i = 0; i < 4; i++) {
+        result += Mul128Fold64(acc[2 * i] ^ Read64(merge_secret + 16 * i),
+                               acc[2 * i + 1] ^ Read64(merge_secret + 16 * i + 8));
+    }
+    return Avalanche(result);
+}
+
+} // Anonymous namespace
+
+u64 XXH3Hash64(const void* data, std::size_t len) noexcept {
+    const u8* input = static_cast<const u8*>(data);
+    if (len <= 16) {
+        return Len0To16(input, len);
+    }
+    if (len <= 128) {
+        return Len17To128(input, len);
+    }
+    if (len <= MIDSIZE_MAX) {
+        return Len129To240(input, len);
+    }
+    return HashLong(input, len);
+}
+
+} // namespace Common
@@ -2,10 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <cstring>
 #include <dynarmic/interface/A32/a32.h>
 #include <dynarmic/interface/optimization_flags.h>
 #include "common/assert.h"
+#include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "core/arm/dynarmic/arm_dynarmic.h"
 #include "core/arm/dynarmic/arm_dynarmic_cp15.h"
@@ -254,8 +256,8 @@ void ARM_Dynarmic::PrepareReschedule() {
 }
 
 void ARM_Dynarmic::ClearInstructionCache() {
-    for (const auto& j : jits) {
-        j.second->ClearCache();
+    for (const auto& entry : jits) {
+        entry.jit->ClearCache();
     }
 }
 
@@ -272,15 +274,20 @@ std::shared_ptr<Memory::PageTable> ARM_Dynarmic::GetPageTable() const {
 }
 
 void ARM_Dynarmic::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_table) {
-    current_page_table = page_table;
     ThreadContext ctx{};
     if (jit) {
         SaveContext(ctx);
     }
+    current_page_table = page_table;
 
-    auto iter = jits.find(current_page_table);
+    // The previous page table may have been the last reference to an exited process.
+    ReleaseUnusedJits();
+
+    auto iter = std::find_if(jits.begin(), jits.end(), [&](const JitEntry& entry) {
+        return entry.page_table == current_page_table.get();
+    });
     if (iter != jits.end()) {
-        jit = iter->second.get();
+        jit = iter->jit.get();
         LoadContext(ctx);
         return;
     }
@@ -288,7 +295,26 @@ void ARM_Dynarmic::SetPageTable(const std::shared_ptr<Memory::PageTable>& page_t
     auto new_jit = MakeJit();
     jit = new_jit.get();
     LoadContext(ctx);
-    jits.emplace(current_page_table, std::move(new_jit));
+    jits.push_back({current_page_table.get(), current_page_table, std::move(new_jit)});
+    LOG_DEBUG(Core_ARM11, "Created JIT for core {}, {} JITs alive", GetID(), jits.size());
+}
+
+void ARM_Dynarmic::ReleaseUnusedJits() {
+    // A page table only outlives its process while it is the current one of a core, so an expired
+    // page table means that the process exited and its code cache can never run again.
+    const auto removed = std::erase_if(jits, [this](const JitEntry& entry) {
+        if (!entry.owner.expired()) {
+            return false;
+        }
+        if (entry.jit.get() == jit) {
+            jit = nullptr;
+        }
+        return true;
+    });
+    if (removed > 0) {
+        LOG_DEBUG(Core_ARM11, "Released {} JITs of exited processes on core {}, {} JITs alive",
+                  removed, GetID(), jits.size());
+    }
 }
 
 void ARM_Dynarmic::ServeBreak() {
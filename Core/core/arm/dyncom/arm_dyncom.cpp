@@ -23,6 +23,10 @@ ARM_DynCom::ARM_DynCom(Core::System& system_, Memory::MemorySystem& memory,
 
 ARM_DynCom::~ARM_DynCom() {}
 
+std::size_t ARM_DynCom::GetTranslationCacheResidentSize() {
+    return trans_cache_buf.ResidentSize();
+}
+
 void ARM_DynCom::Run() {
     ExecuteInstructions(std::max<s64>(timer->GetDowncount(), 0));
 }
@@ -33,7 +37,7 @@ void ARM_DynCom::Step() {
 
 void ARM_DynCom::ClearInstructionCache() {
     state->instruction_cache.clear();
-    trans_cache_buf_top = 0;
+    ClearTransCache();
 }
 
 void ARM_DynCom::InvalidateCacheRange(u32, std::size_t) {
@@ -97,6 +101,8 @@ void ARM_DynCom::SetCP15Register(CP15Register reg, u32 value) {
 }
 
 void ARM_DynCom::ExecuteInstructions(u64 num_instructions) {
+    // No core is inside a translated block between two slices.
+    ApplyTransCacheClear();
     state->NumInstrsToExecute = num_instructions;
     const u32 ticks_executed = InterpreterMainLoop(state.get());
     if (timer) {
@@ -1639,6 +1639,12 @@ DISPATCH: {
     else
         cpu->Reg[15] &= 0xfffffffc;
 
+    // Drop the blocks of an emptied translation cache, it may have been emptied by another core.
+    if (cpu->trans_cache_generation != trans_cache_generation) {
+        cpu->instruction_cache.clear();
+        cpu->trans_cache_generation = trans_cache_generation;
+    }
+
     // Find the cached instruction cream, otherwise translate it...
     auto itr = cpu->instruction_cache.find(cpu->Reg[15]);
     if (itr != cpu->instruction_cache.end()) {
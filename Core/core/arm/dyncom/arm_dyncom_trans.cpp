@@ -6,8 +6,25 @@
 #include "core/arm/skyeye_common/armsupp.h"
 #include "core/arm/skyeye_common/vfp/vfp.h"
 
-char trans_cache_buf[TRANS_CACHE_SIZE];
+// Only the used part of the reservation is committed by POSIX hosts.
+Common::VirtualBuffer<char> trans_cache_buf{TRANS_CACHE_SIZE};
 size_t trans_cache_buf_top = 0;
+u32 trans_cache_generation = 0;
+static bool trans_cache_clear_pending = false;
+
+void ClearTransCache() {
+    trans_cache_clear_pending = true;
+}
+
+void ApplyTransCacheClear() {
+    if (!trans_cache_clear_pending) {
+        return;
+    }
+    trans_cache_clear_pending = false;
+    trans_cache_buf.Decommit(0, trans_cache_buf_top);
+    trans_cache_buf_top = 0;
+    trans_cache_generation++;
+}
 
 static void* AllocBuffer(std::size_t size) {
     std::size_t start = trans_cache_buf_top;
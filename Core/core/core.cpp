@@ -2,15 +2,20 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <ctime>
 #include <stdexcept>
 #include <utility>
 #include <boost/serialization/array.hpp>
+#include <fmt/chrono.h>
 #include "audio_core/dsp_interface.h"
 #include "audio_core/hle/hle.h"
 #include "audio_core/lle/lle.h"
 #include "common/arch.h"
+#include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/memory_detect.h"
 #include "common/settings.h"
+#include "common/tracing.h"
 #include "core/arm/arm_interface.h"
 #include "core/arm/exclusive_monitor.h"
 #include "core/hle/service/cam/cam.h"
@@ -82,7 +87,9 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         return ResultStatus::ErrorNotInitialized;
     }
 
-    if (GDBStub::IsServerEnabled()) {
+    // The socket is read on its own thread, so only sync the context for the gdbstub when it has
+    // something to do.
+    if (GDBStub::IsServerEnabled() && GDBStub::HasPendingWork()) {
         Kernel::Thread* thread = kernel->GetCurrentThreadManager().GetCurrentThread();
         if (thread && running_core) {
             running_core->SaveContext(thread->context);
@@ -393,6 +400,20 @@ PerfStats::Results System::GetLastPerfStats() {
     return perf_stats ? perf_stats->GetLastStats() : PerfStats::Results{};
 }
 
+ResidentMemory System::GetResidentMemory() const {
+    ResidentMemory resident{
+        .process = Common::GetProcessResidentMemory(),
+        .translation_cache = ARM_DynCom::GetTranslationCacheResidentSize(),
+    };
+    if (memory) {
+        const Memory::MemoryFootprint footprint = memory->GetFootprint();
+        resident.fcram = footprint.fcram;
+        resident.vram = footprint.vram;
+        resident.n3ds_extra_ram = footprint.n3ds_extra_ram;
+    }
+    return resident;
+}
+
 double System::GetStableFrameTimeScale() {
     return perf_stats->GetStableFrameTimeScale();
 }
@@ -415,6 +436,10 @@ System::ResultStatus System::Init(Frontend::EmuWindow& emu_window,
                                   const Kernel::New3dsHwCapabilities& n3ds_hw_caps, u32 num_cores) {
     LOG_DEBUG(HW_Memory, "initialized OK");
 
+    if (Settings::values.record_trace) {
+        Common::Tracing::Start();
+    }
+
     memory = std::make_unique<Memory::MemorySystem>(*this);
 
     timing = std::make_unique<Timing>(num_cores, Settings::values.cpu_clock_percentage.GetValue(),
@@ -601,6 +626,21 @@ void System::Shutdown(bool is_deserializing) {
     telemetry_session->AddField(performance, "Mean_Frametime_MS",
                                 perf_stats ? perf_stats->GetMeanFrametime() : 0);
 
+    const ResidentMemory resident = GetResidentMemory();
+    LOG_INFO(Core,
+             "Resident memory: {} KiB total, FCRAM {} KiB, VRAM {} KiB, N3DS RAM {} KiB, "
+             "translation cache {} KiB",
+             resident.process / 1024, resident.fcram / 1024, resident.vram / 1024,
+             resident.n3ds_extra_ram / 1024, resident.translation_cache / 1024);
+
+    // Write the trace of the emulation session
+    if (!is_deserializing && Common::Tracing::IsEnabled()) {
+        const std::time_t t = std::time(nullptr);
+        Common::Tracing::Stop(fmt::format("{}/{:%F-%H-%M-%S}_trace.json",
+                                          FileUtil::GetUserPath(FileUtil::UserPath::LogDir),
+                                          *std::localtime(&t)));
+    }
+
     // Shutdown emulation session
     is_powered_on = false;
 
@@ -745,6 +785,10 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
 
     // Flush on save, don't flush on load
     const bool should_flush = !Archive::is_loading::value;
+    if (should_flush) {
+        // Finish the work of the GPU thread so its interrupts are part of the saved state.
+        gpu->Synchronize();
+    }
     gpu->ClearAll(should_flush);
     ar&* timing.get();
     for (u32 i = 0; i < num_cores; i++) {
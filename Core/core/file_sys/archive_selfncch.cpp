@@ -255,6 +255,10 @@ void ArchiveFactory_SelfNCCH::Register(Loader::AppLoader& app_loader) {
             "Could not read program id when registering with SelfNCCH, this might be a 3dsx file");
     }
 
+    Register(program_id, ReadNCCHData(app_loader));
+}
+
+void ArchiveFactory_SelfNCCH::Register(u64 program_id, NCCHData data) {
     LOG_DEBUG(Service_FS, "Registering program {:016X} with the SelfNCCH archive factory",
               program_id);
 
@@ -264,7 +268,22 @@ void ArchiveFactory_SelfNCCH::Register(Loader::AppLoader& app_loader) {
                     program_id);
     }
 
-    NCCHData& data = ncch_data[program_id];
+    // Contents that could not be read keep the ones of the previous mapping.
+    NCCHData& entry = ncch_data[program_id];
+    if (data.romfs_file)
+        entry.romfs_file = std::move(data.romfs_file);
+    if (data.update_romfs_file)
+        entry.update_romfs_file = std::move(data.update_romfs_file);
+    if (data.icon)
+        entry.icon = std::move(data.icon);
+    if (data.logo)
+        entry.logo = std::move(data.logo);
+    if (data.banner)
+        entry.banner = std::move(data.banner);
+}
+
+NCCHData ArchiveFactory_SelfNCCH::ReadNCCHData(Loader::AppLoader& app_loader) {
+    NCCHData data;
 
     std::shared_ptr<RomFSReader> romfs_file_;
     if (Loader::ResultStatus::Success == app_loader.ReadRomFS(romfs_file_)) {
@@ -290,6 +309,8 @@ void ArchiveFactory_SelfNCCH::Register(Loader::AppLoader& app_loader) {
     buffer.clear();
     if (Loader::ResultStatus::Success == app_loader.ReadBanner(buffer))
         data.banner = std::make_shared<std::vector<u8>>(std::move(buffer));
+
+    return data;
 }
 
 ResultVal<std::unique_ptr<ArchiveBackend>> ArchiveFactory_SelfNCCH::Open(const Path& path,
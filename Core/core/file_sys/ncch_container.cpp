@@ -2,6 +2,9 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cstring>
 #include <memory>
 #include <span>
@@ -9,7 +12,9 @@
 #include <cryptopp/modes.h>
 #include <cryptopp/sha.h>
 #include "common/common_types.h"
+#include "common/literals.h"
 #include "common/logging/log.h"
+#include "common/task_scheduler.h"
 #include "core/core.h"
 #include "core/file_sys/layered_fs.h"
 #include "core/file_sys/ncch_container.h"
@@ -23,6 +28,8 @@ namespace FileSys {
 static const int kMaxSections = 8;   ///< Maximum number of sections (files) in an ExeFs
 static const int kBlockSize = 0x200; ///< Size of ExeFS blocks (in bytes)
 
+using namespace Common::Literals;
+
 u64 GetModId(u64 program_id) {
     constexpr u64 UPDATE_MASK = 0x0000000e'00000000;
     if ((program_id & 0x000000ff'00000000) == UPDATE_MASK) { // Apply the mods to updates
@@ -43,6 +50,29 @@ static std::size_t LZSS_GetDecompressedSize(std::span<const u8> buffer) {
     return offset_size + buffer.size();
 }
 
+/// Copies 1 to 18 bytes between non-overlapping buffers using fixed size moves.
+static void LZSS_CopyRun(u8* dst, const u8* src, std::size_t size) {
+    const auto move = [&]<std::size_t N>(std::size_t offset) {
+        std::array<u8, N> word;
+        std::memcpy(word.data(), src + offset, N);
+        std::memcpy(dst + offset, word.data(), N);
+    };
+    if (size >= 8) {
+        for (std::size_t offset = 0; offset + 8 < size; offset += 8) {
+            move.template operator()<8>(offset);
+        }
+        move.template operator()<8>(size - 8);
+    } else if (size >= 4) {
+        move.template operator()<4>(0);
+        move.template operator()<4>(size - 4);
+    } else if (size >= 2) {
+        move.template operator()<2>(0);
+        move.template operator()<2>(size - 2);
+    } else if (size == 1) {
+        *dst = *src;
+    }
+}
+
 /**
  * Decompress ExeFS file (compressed with LZSS)
  * @param compressed Compressed buffer
@@ -52,6 +82,9 @@ static std::size_t LZSS_GetDecompressedSize(std::span<const u8> buffer) {
  * @return True on success, otherwise false
  */
 static bool LZSS_Decompress(std::span<const u8> compressed, std::span<u8> decompressed) {
+    if (compressed.size() < 8 || decompressed.size() < compressed.size()) {
+        return false;
+    }
     const u8* footer = compressed.data() + compressed.size() - 8;
 
     u32 buffer_top_and_bottom;
@@ -59,54 +92,114 @@ static bool LZSS_Decompress(std::span<const u8> compressed, std::span<u8> decomp
 
     std::size_t out = decompressed.size();
     std::size_t index = compressed.size() - ((buffer_top_and_bottom >> 24) & 0xFF);
-    std::size_t stop_index = compressed.size() - (buffer_top_and_bottom & 0xFFFFFF);
+    const std::size_t stop_index = compressed.size() - (buffer_top_and_bottom & 0xFFFFFF);
 
-    std::memset(decompressed.data(), 0, decompressed.size());
     std::memcpy(decompressed.data(), compressed.data(), compressed.size());
+    std::memset(decompressed.data() + compressed.size(), 0,
+                decompressed.size() - compressed.size());
 
+    // The stream is decoded from the end towards the start. Runs of literals and back references
+    // are copied as whole blocks instead of one byte at a time.
     while (index > stop_index) {
-        u8 control = compressed[--index];
+        u32 control = compressed[--index];
 
-        for (unsigned i = 0; i < 8; i++) {
-            if (index <= stop_index)
-                break;
-            if (index <= 0)
-                break;
-            if (out <= 0)
+        for (unsigned i = 0; i < 8;) {
+            if (index <= stop_index || out == 0) {
                 break;
+            }
 
-            if (control & 0x80) {
-                // Check if compression is out of bounds
-                if (index < 2)
-                    return false;
-                index -= 2;
+            if ((control & 0x80) == 0) {
+                // Count the literals flagged by the leading zero bits of the control byte.
+                const unsigned flagged = std::min<unsigned>(
+                    static_cast<unsigned>(std::countl_zero(static_cast<u8>(control))), 8 - i);
+                const std::size_t run =
+                    std::min<std::size_t>({flagged, index - stop_index, out});
+                index -= run;
+                out -= run;
+                LZSS_CopyRun(decompressed.data() + out, compressed.data() + index, run);
+                control <<= run;
+                i += static_cast<unsigned>(run);
+                continue;
+            }
 
-                u32 segment_offset = compressed[index] | (compressed[index + 1] << 8);
-                u32 segment_size = ((segment_offset >> 12) & 15) + 3;
-                segment_offset &= 0x0FFF;
-                segment_offset += 2;
+            // Check if compression is out of bounds
+            if (index < 2) {
+                return false;
+            }
+            index -= 2;
 
-                // Check if compression is out of bounds
-                if (out < segment_size)
-                    return false;
+            const u32 segment = compressed[index] | (compressed[index + 1] << 8);
+            const std::size_t segment_size = ((segment >> 12) & 15) + 3;
+            const std::size_t distance = (segment & 0x0FFF) + 3;
 
-                for (unsigned j = 0; j < segment_size; j++) {
-                    // Check if compression is out of bounds
-                    if (out + segment_offset >= decompressed.size())
-                        return false;
+            // Check if compression is out of bounds
+            if (out < segment_size || out + distance > decompressed.size()) {
+                return false;
+            }
 
-                    u8 data = decompressed[out + segment_offset];
-                    decompressed[--out] = data;
-                }
+            out -= segment_size;
+            u8* const dst = decompressed.data() + out;
+            if (distance >= segment_size) {
+                LZSS_CopyRun(dst, dst + distance, segment_size);
             } else {
-                // Check if compression is out of bounds
-                if (out < 1)
-                    return false;
-                decompressed[--out] = compressed[--index];
+                // Overlapping references repeat the last distance bytes, copy them from the top
+                // so that every byte read was already written.
+                for (std::size_t j = segment_size; j-- > 0;) {
+                    dst[j] = dst[j + distance];
+                }
             }
             control <<= 1;
+            i++;
+        }
+    }
+    return true;
+}
+
+/**
+ * Read an ExeFS section, decrypting the data already read on the worker threads while the rest
+ * of the section is read from disk
+ * @param file File positioned at the start of the section
+ * @param buffer Buffer receiving the section
+ * @param key Key of the section, or nullptr if the section is not encrypted
+ * @param ctr Initial counter of the ExeFS
+ * @param ctr_offset Offset of the section from the start of the ExeFS
+ * @return True on success, otherwise false
+ */
+static bool ReadExeFSSection(FileUtil::IOFile& file, std::span<u8> buffer,
+                             const std::array<u8, 16>* key, const std::array<u8, 16>& ctr,
+                             u64 ctr_offset) {
+    constexpr std::size_t ChunkSize = 1_MiB;
+
+    const auto decrypt = [key, &ctr](std::span<u8> chunk, u64 offset) {
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key->data(), key->size(), ctr.data());
+        dec.Seek(offset);
+        dec.ProcessData(chunk.data(), chunk.data(), chunk.size());
+    };
+
+    if (!key || buffer.size() <= ChunkSize) {
+        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
+            return false;
+        }
+        if (key) {
+            decrypt(buffer, ctr_offset);
+        }
+        return true;
+    }
+
+    // AES-CTR can start at any offset, so every chunk is decrypted independently.
+    Common::TaskGroup decrypt_workers{"NCCH decrypt",
+                                      Common::TaskScheduler::Instance().NumWorkers()};
+    for (std::size_t offset = 0; offset < buffer.size(); offset += ChunkSize) {
+        const std::span<u8> chunk =
+            buffer.subspan(offset, std::min(ChunkSize, buffer.size() - offset));
+        if (file.ReadBytes(chunk.data(), chunk.size()) != chunk.size()) {
+            return false;
         }
+        decrypt_workers.QueueWork([&decrypt, chunk, offset = ctr_offset + offset] {
+            decrypt(chunk, offset);
+        });
     }
+    decrypt_workers.Wait();
     return true;
 }
 
@@ -427,6 +520,7 @@ Loader::ResultStatus NCCHContainer::Load() {
             }
 
             exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_filepath = filepath;
             has_exefs = true;
         }
 
@@ -456,6 +550,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
     std::string exefsdir_override = filepath + ".exefsdir/";
     if (FileUtil::Exists(exefs_override)) {
         exefs_file = FileUtil::IOFile(exefs_override, "rb");
+        exefs_filepath = exefs_override;
 
         if (exefs_file.ReadBytes(&exefs_header, sizeof(ExeFs_Header)) == sizeof(ExeFs_Header)) {
             LOG_DEBUG(Service_FS, "Loading ExeFS section from {}", exefs_override);
@@ -464,6 +559,7 @@ Loader::ResultStatus NCCHContainer::LoadOverrides() {
             has_exefs = true;
         } else {
             exefs_file = FileUtil::IOFile(filepath, "rb");
+            exefs_filepath = filepath;
         }
     } else if (FileUtil::Exists(exefsdir_override) && FileUtil::IsDirectory(exefsdir_override)) {
         is_tainted = true;
@@ -494,10 +590,12 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
             std::size_t logo_offset = ncch_header.logo_region_offset * kBlockSize;
             std::size_t logo_size = ncch_header.logo_region_size * kBlockSize;
 
+            // Sections may be loaded from several threads, read through a private handle.
+            FileUtil::IOFile logo_file{filepath, "rb"};
             buffer.resize(logo_size);
-            file.Seek(ncch_offset + logo_offset, SEEK_SET);
+            logo_file.Seek(ncch_offset + logo_offset, SEEK_SET);
 
-            if (file.ReadBytes(buffer.data(), logo_size) != logo_size) {
+            if (logo_file.ReadBytes(buffer.data(), logo_size) != logo_size) {
                 LOG_ERROR(Service_FS, "Could not read NCCH logo");
                 return Loader::ResultStatus::Error;
             }
@@ -523,31 +621,29 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
 
             s64 section_offset =
                 (section.offset + exefs_offset + sizeof(ExeFs_Header) + ncch_offset);
-            exefs_file.Seek(section_offset, SEEK_SET);
+            FileUtil::IOFile section_file{exefs_filepath, "rb"};
+            section_file.Seek(section_offset, SEEK_SET);
 
-            std::array<u8, 16> key;
-            if (strcmp(section.name, "icon") == 0 || strcmp(section.name, "banner") == 0) {
-                key = primary_key;
-            } else {
-                key = secondary_key;
+            const std::array<u8, 16>* key = nullptr;
+            if (is_encrypted) {
+                if (strcmp(section.name, "icon") == 0 || strcmp(section.name, "banner") == 0) {
+                    key = &primary_key;
+                } else {
+                    key = &secondary_key;
+                }
             }
-
-            CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption dec(key.data(), key.size(),
-                                                              exefs_ctr.data());
-            dec.Seek(section.offset + sizeof(ExeFs_Header));
+            const u64 ctr_offset = section.offset + sizeof(ExeFs_Header);
 
             if (strcmp(section.name, ".code") == 0 && is_compressed) {
                 // Section is compressed, read compressed .code section...
                 std::vector<u8> temp_buffer(section.size);
-                if (exefs_file.ReadBytes(temp_buffer.data(), temp_buffer.size()) !=
-                    temp_buffer.size())
+                if (!ReadExeFSSection(section_file, temp_buffer, key, exefs_ctr, ctr_offset))
                     return Loader::ResultStatus::Error;
 
-                if (is_encrypted) {
-                    dec.ProcessData(&temp_buffer[0], &temp_buffer[0], section.size);
-                }
-
                 // Decompress .code section...
+                if (temp_buffer.size() < 8) {
+                    return Loader::ResultStatus::ErrorInvalidFormat;
+                }
                 buffer.resize(LZSS_GetDecompressedSize(temp_buffer));
                 if (!LZSS_Decompress(temp_buffer, buffer)) {
                     return Loader::ResultStatus::ErrorInvalidFormat;
@@ -555,11 +651,8 @@ Loader::ResultStatus NCCHContainer::LoadSectionExeFS(const char* name, std::vect
             } else {
                 // Section is uncompressed...
                 buffer.resize(section.size);
-                if (exefs_file.ReadBytes(buffer.data(), section.size) != section.size)
+                if (!ReadExeFSSection(section_file, buffer, key, exefs_ctr, ctr_offset))
                     return Loader::ResultStatus::Error;
-                if (is_encrypted) {
-                    dec.ProcessData(buffer.data(), buffer.data(), section.size);
-                }
             }
 
             return Loader::ResultStatus::Success;
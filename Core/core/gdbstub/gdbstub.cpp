@@ -5,13 +5,24 @@
 // Originally written by Sven Peter <sven@fail0verflow.com> for anergistic.
 
 #include <algorithm>
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <csignal>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 #include <fcntl.h>
 #include <fmt/format.h>
 
@@ -31,6 +42,7 @@
 #endif
 
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/gdbstub/gdbstub.h"
@@ -46,6 +58,14 @@ constexpr char GDB_STUB_START = '$';
 constexpr char GDB_STUB_END = '#';
 constexpr char GDB_STUB_ACK = '+';
 constexpr char GDB_STUB_NACK = '-';
+constexpr char GDB_STUB_ESCAPE = '}';
+constexpr u8 GDB_STUB_INTERRUPT = 0x03;
+
+// Largest amount of data sent in one binary reply, escaping may double its size on the wire.
+constexpr u32 MAX_BINARY_TRANSFER = GDB_BUFFER_SIZE / 2 - 4;
+
+// How long a halted emulation thread sleeps waiting for a command before returning to its loop.
+constexpr std::chrono::milliseconds HALTED_WAIT_INTERVAL{10};
 
 #ifndef SIGTRAP
 constexpr u32 SIGTRAP = 5;
@@ -55,10 +75,6 @@ constexpr u32 SIGTRAP = 5;
 constexpr u32 SIGTERM = 15;
 #endif
 
-#ifndef MSG_WAITALL
-constexpr u32 MSG_WAITALL = 8;
-#endif
-
 constexpr u32 SP_REGISTER = 13;
 constexpr u32 LR_REGISTER = 14;
 constexpr u32 PC_REGISTER = 15;
@@ -67,10 +83,10 @@ constexpr u32 D0_REGISTER = 26;
 constexpr u32 FPSCR_REGISTER = 42;
 
 // For sample XML files see the GDB source /gdb/features
-// GDB also wants the l character at the start
+// It is sent through qXfer, which adds the m or l prefix of every chunk
 // This XML defines what the registers are for this specific ARM device
-constexpr char target_xml[] =
-    R"(l<?xml version="1.0"?>
+constexpr std::string_view target_xml =
+    R"(<?xml version="1.0"?>
 <!DOCTYPE target SYSTEM "gdb-target.dtd">
 <target version="1.0">
   <feature name="org.gnu.gdb.arm.core">
@@ -125,6 +141,19 @@ bool defer_start = false;
 u8 command_buffer[GDB_BUFFER_SIZE];
 u32 command_length;
 
+// The socket is read by a dedicated thread, which queues complete packets for the emulation
+// thread. The emulation thread only looks at the queue once command_pending is set.
+std::thread reader_thread;
+std::mutex packet_mutex;
+std::condition_variable packet_cv;
+std::deque<std::vector<u8>> pending_packets;
+bool connection_lost = false;
+std::atomic<bool> command_pending(false);
+
+// Serializes the acknowledgements sent by the reader thread with the replies of the emulation
+// thread and guards gdbserver_socket against being reset while the reader thread sends.
+std::mutex send_mutex;
+
 u32 latest_signal = 0;
 bool memory_break = false;
 
@@ -151,6 +180,7 @@ struct Breakpoint {
     VAddr addr;
     u32 len;
     std::array<u8, 4> inst;
+    u32 inst_size;
 };
 
 using BreakpointMap = std::map<VAddr, Breakpoint>;
@@ -356,23 +386,49 @@ static u64 GdbHexToLong(const u8* src) {
     return output;
 }
 
-/// Read a byte from the gdb client.
-static u8 ReadByte() {
-    u8 c;
-    std::size_t received_size = recv(gdbserver_socket, reinterpret_cast<char*>(&c), 1, MSG_WAITALL);
-    if (received_size != 1) {
-        LOG_ERROR(Debug_GDBStub, "recv failed : {}", received_size);
-        Shutdown();
-    }
-
-    return c;
-}
-
 /// Calculate the checksum of the current command buffer.
 static u8 CalculateChecksum(const u8* buffer, std::size_t length) {
     return static_cast<u8>(std::accumulate(buffer, buffer + length, 0, std::plus<u8>()));
 }
 
+/**
+ * Append binary data to a reply, escaping the bytes that gdb treats as packet delimiters.
+ *
+ * @param reply Reply to append the data to.
+ * @param data Pointer to the binary data.
+ * @param length Length of the binary data.
+ */
+static void AppendBinary(std::string& reply, const u8* data, std::size_t length) {
+    for (std::size_t i = 0; i < length; i++) {
+        const u8 c = data[i];
+        if (c == GDB_STUB_START || c == GDB_STUB_END || c == GDB_STUB_ESCAPE || c == '*') {
+            reply += GDB_STUB_ESCAPE;
+            reply += static_cast<char>(c ^ 0x20);
+        } else {
+            reply += static_cast<char>(c);
+        }
+    }
+}
+
+/**
+ * Decode binary data received from the gdb client in place.
+ *
+ * @param data Pointer to the escaped binary data.
+ * @param length Length of the escaped binary data.
+ * @returns The length of the decoded data.
+ */
+static std::size_t UnescapeBinary(u8* data, std::size_t length) {
+    std::size_t out = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        if (data[i] == GDB_STUB_ESCAPE && i + 1 < length) {
+            data[out++] = data[++i] ^ 0x20;
+        } else {
+            data[out++] = data[i];
+        }
+    }
+    return out;
+}
+
 /**
  * Get the map of breakpoints for a given breakpoint type.
  *
@@ -411,11 +467,8 @@ static void RemoveBreakpoint(BreakpointType type, VAddr addr) {
     if (type == BreakpointType::Execute) {
         Core::System::GetInstance().Memory().WriteBlock(
             *Core::System::GetInstance().Kernel().GetCurrentProcess(), bp->second.addr,
-            bp->second.inst.data(), bp->second.inst.size());
-        u32 num_cores = Core::GetNumCores();
-        for (u32 i = 0; i < num_cores; ++i) {
-            Core::GetCore(i).ClearInstructionCache();
-        }
+            bp->second.inst.data(), bp->second.inst_size);
+        Core::System::GetInstance().InvalidateCacheRange(bp->second.addr, bp->second.inst_size);
     }
     p.erase(addr);
 }
@@ -479,46 +532,90 @@ bool CheckBreakpoint(VAddr addr, BreakpointType type) {
  * @param packet Packet to be sent to client.
  */
 static void SendPacket(const char packet) {
+    std::scoped_lock lock{send_mutex};
+    if (gdbserver_socket == -1) {
+        return;
+    }
+
     std::size_t sent_size = send(gdbserver_socket, &packet, 1, 0);
     if (sent_size != 1) {
         LOG_ERROR(Debug_GDBStub, "send failed");
     }
 }
 
-void SendReply(const char* reply) {
+/**
+ * Send a reply with an arbitrary payload, which may contain escaped binary data, to gdb client.
+ *
+ * @param payload Payload of the reply.
+ */
+static void SendPayload(std::string_view payload) {
     if (!IsConnected()) {
         return;
     }
 
-    std::memset(command_buffer, 0, sizeof(command_buffer));
+    const u8 checksum =
+        CalculateChecksum(reinterpret_cast<const u8*>(payload.data()), payload.size());
+
+    std::string packet;
+    packet.reserve(payload.size() + 4);
+    packet += GDB_STUB_START;
+    packet += payload;
+    packet += GDB_STUB_END;
+    packet += static_cast<char>(NibbleToHex(checksum >> 4));
+    packet += static_cast<char>(NibbleToHex(checksum));
+
+    bool failed = false;
+    {
+        std::scoped_lock lock{send_mutex};
+        const char* ptr = packet.data();
+        u32 left = static_cast<u32>(packet.size());
+        while (left > 0) {
+            s32 sent_size = static_cast<s32>(send(gdbserver_socket, ptr, left, 0));
+            if (sent_size < 0) {
+                failed = true;
+                break;
+            }
 
-    command_length = static_cast<u32>(strlen(reply));
-    if (command_length + 4 > sizeof(command_buffer)) {
-        LOG_ERROR(Debug_GDBStub, "command_buffer overflow in SendReply");
-        return;
+            left -= sent_size;
+            ptr += sent_size;
+        }
     }
 
-    std::memcpy(command_buffer + 1, reply, command_length);
+    if (failed) {
+        LOG_ERROR(Debug_GDBStub, "gdb: send failed");
+        Shutdown();
+    }
+}
 
-    u8 checksum = CalculateChecksum(command_buffer, command_length + 1);
-    command_buffer[0] = GDB_STUB_START;
-    command_buffer[command_length + 1] = GDB_STUB_END;
-    command_buffer[command_length + 2] = NibbleToHex(checksum >> 4);
-    command_buffer[command_length + 3] = NibbleToHex(checksum);
+void SendReply(const char* reply) {
+    SendPayload(reply);
+}
 
-    u8* ptr = command_buffer;
-    u32 left = command_length + 4;
-    while (left > 0) {
-        s32 sent_size =
-            static_cast<s32>(send(gdbserver_socket, reinterpret_cast<char*>(ptr), left, 0));
-        if (sent_size < 0) {
-            LOG_ERROR(Debug_GDBStub, "gdb: send failed");
-            return Shutdown();
-        }
+/**
+ * Send the window of a qXfer object requested by gdb client. Objects larger than a packet are
+ * read in several requests, every reply except the one containing the end is prefixed with 'm'.
+ *
+ * @param object Contents of the requested object.
+ * @param window Pointer to the "offset,length" part of the query.
+ */
+static void SendXferReply(std::string_view object, const char* window) {
+    const char* separator = std::strchr(window, ',');
+    if (!separator) {
+        return SendReply("E01");
+    }
 
-        left -= sent_size;
-        ptr += sent_size;
+    const u32 offset = HexToInt(reinterpret_cast<const u8*>(window), separator - window);
+    const u32 length =
+        HexToInt(reinterpret_cast<const u8*>(separator + 1), std::strlen(separator + 1));
+    if (offset > object.size()) {
+        return SendReply("E01");
     }
+
+    const std::size_t size = std::min<std::size_t>(
+        {length, object.size() - offset, static_cast<std::size_t>(MAX_BINARY_TRANSFER)});
+    std::string reply(1, offset + size < object.size() ? 'm' : 'l');
+    AppendBinary(reply, reinterpret_cast<const u8*>(object.data()) + offset, size);
+    SendPayload(reply);
 }
 
 /// Handle query command from gdb client.
@@ -529,11 +626,12 @@ static void HandleQuery() {
     if (strcmp(query, "TStatus") == 0) {
         SendReply("T0");
     } else if (strncmp(query, "Supported", strlen("Supported")) == 0) {
-        // PacketSize needs to be large enough for target xml
-        SendReply("PacketSize=2000;qXfer:features:read+;qXfer:threads:read+");
+        SendReply("PacketSize=2000;qXfer:features:read+;qXfer:threads:read+;binary-upload+");
     } else if (strncmp(query, "Xfer:features:read:target.xml:",
                        strlen("Xfer:features:read:target.xml:")) == 0) {
-        SendReply(target_xml);
+        SendXferReply(target_xml, query + strlen("Xfer:features:read:target.xml:"));
+    } else if (strncmp(query, "Xfer:features:read:", strlen("Xfer:features:read:")) == 0) {
+        SendReply("E00");
     } else if (strncmp(query, "fThreadInfo", strlen("fThreadInfo")) == 0) {
         std::string val = "m";
         u32 num_cores = Core::GetNumCores();
@@ -548,9 +646,9 @@ static void HandleQuery() {
         SendReply(val.c_str());
     } else if (strncmp(query, "sThreadInfo", strlen("sThreadInfo")) == 0) {
         SendReply("l");
-    } else if (strncmp(query, "Xfer:threads:read", strlen("Xfer:threads:read")) == 0) {
+    } else if (strncmp(query, "Xfer:threads:read::", strlen("Xfer:threads:read::")) == 0) {
         std::string buffer;
-        buffer += "l<?xml version=\"1.0\"?>";
+        buffer += "<?xml version=\"1.0\"?>";
         buffer += "<threads>";
         u32 num_cores = Core::GetNumCores();
         for (u32 i = 0; i < num_cores; ++i) {
@@ -562,7 +660,7 @@ static void HandleQuery() {
             }
         }
         buffer += "</threads>";
-        SendReply(buffer.c_str());
+        SendXferReply(buffer, query + strlen("Xfer:threads:read::"));
     } else {
         SendReply("");
     }
@@ -636,76 +734,140 @@ static void SendSignal(Kernel::Thread* thread, u32 signal, bool full = true) {
     SendReply(buffer.c_str());
 }
 
-/// Read command from gdb client.
-static void ReadCommand() {
-    command_length = 0;
-    std::memset(command_buffer, 0, sizeof(command_buffer));
-
-    u8 c = ReadByte();
-    if (c == GDB_STUB_ACK) {
-        // ignore ack
-        return;
-    } else if (c == 0x03) {
-        LOG_INFO(Debug_GDBStub, "gdb: found break command\n");
-        halt_loop = true;
-        SendSignal(current_thread, SIGTRAP);
-        return;
-    } else if (c != GDB_STUB_START) {
-        LOG_DEBUG(Debug_GDBStub, "gdb: read invalid byte {:02x}\n", c);
-        return;
+/// Queue a packet received from gdb client for the emulation thread.
+static void QueuePacket(std::vector<u8>&& packet) {
+    {
+        std::scoped_lock lock{packet_mutex};
+        pending_packets.push_back(std::move(packet));
+        command_pending = true;
     }
+    packet_cv.notify_one();
+}
 
-    while ((c = ReadByte()) != GDB_STUB_END) {
-        if (command_length >= sizeof(command_buffer)) {
-            LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
-            SendPacket(GDB_STUB_NACK);
-            return;
+/**
+ * Receive packets from gdb client until the connection is closed. This runs on its own thread, so
+ * the emulation thread never polls the socket. Complete packets are acknowledged here and queued.
+ *
+ * @param socket Socket connected to gdb client.
+ */
+static void ReaderLoop(int socket) {
+    Common::SetCurrentThreadName("GDBStub");
+
+    enum class State {
+        Idle,
+        Payload,
+        ChecksumHigh,
+        ChecksumLow,
+    };
+
+    State state = State::Idle;
+    std::vector<u8> payload;
+    u8 checksum_received = 0;
+    std::array<char, 4096> buffer;
+
+    while (true) {
+        const auto received_size = recv(socket, buffer.data(), buffer.size(), 0);
+        if (received_size <= 0) {
+            break;
         }
-        command_buffer[command_length++] = c;
-    }
 
-    u8 checksum_received = HexCharToValue(ReadByte()) << 4;
-    checksum_received |= HexCharToValue(ReadByte());
-
-    u8 checksum_calculated = CalculateChecksum(command_buffer, command_length);
+        for (const char byte : std::span{buffer.data(), static_cast<std::size_t>(received_size)}) {
+            const u8 c = static_cast<u8>(byte);
+            switch (state) {
+            case State::Idle:
+                if (c == GDB_STUB_START) {
+                    payload.clear();
+                    state = State::Payload;
+                } else if (c == GDB_STUB_INTERRUPT) {
+                    QueuePacket({c});
+                } else if (c != GDB_STUB_ACK && c != GDB_STUB_NACK) {
+                    LOG_DEBUG(Debug_GDBStub, "gdb: read invalid byte {:02x}\n", c);
+                }
+                break;
+            case State::Payload:
+                if (c == GDB_STUB_END) {
+                    state = State::ChecksumHigh;
+                } else if (payload.size() >= sizeof(command_buffer) - 1) {
+                    LOG_ERROR(Debug_GDBStub, "gdb: command_buffer overflow\n");
+                    SendPacket(GDB_STUB_NACK);
+                    state = State::Idle;
+                } else {
+                    payload.push_back(c);
+                }
+                break;
+            case State::ChecksumHigh:
+                checksum_received = HexCharToValue(c) << 4;
+                state = State::ChecksumLow;
+                break;
+            case State::ChecksumLow: {
+                checksum_received |= HexCharToValue(c);
+                state = State::Idle;
+
+                const u8 checksum_calculated = CalculateChecksum(payload.data(), payload.size());
+                if (checksum_received != checksum_calculated) {
+                    LOG_ERROR(Debug_GDBStub,
+                              "gdb: invalid checksum: calculated {:02x} and read {:02x} (length: "
+                              "{})\n",
+                              checksum_calculated, checksum_received, payload.size());
+                    SendPacket(GDB_STUB_NACK);
+                    break;
+                }
+
+                SendPacket(GDB_STUB_ACK);
+                QueuePacket(std::exchange(payload, {}));
+                break;
+            }
+            }
+        }
+    }
 
-    if (checksum_received != checksum_calculated) {
-        LOG_ERROR(
-            Debug_GDBStub,
-            "gdb: invalid checksum: calculated {:02x} and read {:02x} for ${}# (length: {})\n",
-            checksum_calculated, checksum_received, reinterpret_cast<const char*>(command_buffer),
-            command_length);
+    {
+        std::scoped_lock lock{packet_mutex};
+        connection_lost = true;
+        command_pending = true;
+    }
+    packet_cv.notify_one();
+}
 
-        command_length = 0;
+/**
+ * Move the oldest packet queued by the reader thread to the command buffer. While the CPU is
+ * halted this waits a short while for one to arrive instead of spinning.
+ *
+ * @returns false if no packet was queued or the connection was lost.
+ */
+static bool ReadCommand() {
+    command_length = 0;
 
-        SendPacket(GDB_STUB_NACK);
-        return;
+    std::unique_lock lock{packet_mutex};
+    if (pending_packets.empty() && !connection_lost && halt_loop) {
+        packet_cv.wait_for(lock, HALTED_WAIT_INTERVAL,
+                           [] { return !pending_packets.empty() || connection_lost; });
     }
 
-    SendPacket(GDB_STUB_ACK);
-}
-
-/// Check if there is data to be read from the gdb client.
-static bool IsDataAvailable() {
-    if (!IsConnected()) {
+    if (connection_lost) {
+        lock.unlock();
+        LOG_INFO(Debug_GDBStub, "gdb: connection closed by client");
+        Shutdown();
+        // Continue execution so we don't hang forever without a client
+        halt_loop = false;
+        step_loop = false;
         return false;
     }
 
-    fd_set fd_socket;
-
-    FD_ZERO(&fd_socket);
-    FD_SET(static_cast<u32>(gdbserver_socket), &fd_socket);
-
-    struct timeval t;
-    t.tv_sec = 0;
-    t.tv_usec = 0;
-
-    if (select(gdbserver_socket + 1, &fd_socket, nullptr, nullptr, &t) < 0) {
-        LOG_ERROR(Debug_GDBStub, "select failed");
+    if (pending_packets.empty()) {
+        command_pending = false;
         return false;
     }
 
-    return FD_ISSET(gdbserver_socket, &fd_socket) != 0;
+    const std::vector<u8> packet = std::move(pending_packets.front());
+    pending_packets.pop_front();
+    command_pending = !pending_packets.empty();
+    lock.unlock();
+
+    std::memset(command_buffer, 0, sizeof(command_buffer));
+    std::memcpy(command_buffer, packet.data(), packet.size());
+    command_length = static_cast<u32>(packet.size());
+    return true;
 }
 
 /// Send requested register to gdb client.
@@ -834,8 +996,8 @@ static void ReadMemory() {
 
     LOG_DEBUG(Debug_GDBStub, "ReadMemory addr: {:08x} len: {:08x}", addr, len);
 
-    if (len * 2 > sizeof(reply)) {
-        SendReply("E01");
+    if (len * 2 >= sizeof(reply)) {
+        return SendReply("E01");
     }
 
     auto& memory = Core::System::GetInstance().Memory();
@@ -876,7 +1038,75 @@ static void WriteMemory() {
 
     GdbHexToMem(data.data(), len_pos + 1, len);
     memory.WriteBlock(addr, data.data(), len);
-    Core::GetRunningCore().ClearInstructionCache();
+    Core::System::GetInstance().InvalidateCacheRange(addr, len);
+    SendReply("OK");
+}
+
+/// Read location in memory specified by gdb client and send it back as binary data.
+static void ReadMemoryBinary() {
+    auto start_offset = command_buffer + 1;
+    auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
+    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+
+    start_offset = addr_pos + 1;
+    u32 len =
+        HexToInt(start_offset, static_cast<u32>((command_buffer + command_length) - start_offset));
+
+    LOG_DEBUG(Debug_GDBStub, "ReadMemoryBinary addr: {:08x} len: {:08x}", addr, len);
+
+    // gdb probes for the packet with an empty read, and accepts replies shorter than requested
+    std::string reply = "b";
+    len = std::min(len, MAX_BINARY_TRANSFER);
+    if (len == 0) {
+        return SendPayload(reply);
+    }
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                                      addr)) {
+        return SendReply("E00");
+    }
+
+    std::vector<u8> data(len);
+    memory.ReadBlock(addr, data.data(), len);
+
+    AppendBinary(reply, data.data(), len);
+    SendPayload(reply);
+}
+
+/// Modify location in memory with binary data received from the gdb client.
+static void WriteMemoryBinary() {
+    auto start_offset = command_buffer + 1;
+    auto addr_pos = std::find(start_offset, command_buffer + command_length, ',');
+    VAddr addr = HexToInt(start_offset, static_cast<u32>(addr_pos - start_offset));
+
+    start_offset = addr_pos + 1;
+    auto len_pos = std::find(start_offset, command_buffer + command_length, ':');
+    if (len_pos == command_buffer + command_length) {
+        return SendReply("E01");
+    }
+    u32 len = HexToInt(start_offset, static_cast<u32>(len_pos - start_offset));
+
+    u8* data = len_pos + 1;
+    const std::size_t data_length =
+        UnescapeBinary(data, static_cast<std::size_t>((command_buffer + command_length) - data));
+    if (data_length != len) {
+        return SendReply("E01");
+    }
+
+    // gdb probes for the packet with an empty write
+    if (len == 0) {
+        return SendReply("OK");
+    }
+
+    auto& memory = Core::System::GetInstance().Memory();
+    if (!memory.IsValidVirtualAddress(*Core::System::GetInstance().Kernel().GetCurrentProcess(),
+                                      addr)) {
+        return SendReply("E00");
+    }
+
+    memory.WriteBlock(addr, data, len);
+    Core::System::GetInstance().InvalidateCacheRange(addr, len);
     SendReply("OK");
 }
 
@@ -911,7 +1141,6 @@ static void Continue() {
     memory_break = false;
     step_loop = false;
     halt_loop = false;
-    Core::GetRunningCore().ClearInstructionCache();
 }
 
 /**
@@ -924,20 +1153,33 @@ static void Continue() {
 static bool CommitBreakpoint(BreakpointType type, VAddr addr, u32 len) {
     BreakpointMap& p = GetBreakpointMap(type);
 
+    // gdb inserts breakpoints again when resuming, keep the instruction saved the first time.
+    if (p.contains(addr)) {
+        return true;
+    }
+
     Breakpoint breakpoint;
     breakpoint.active = true;
     breakpoint.addr = addr;
     breakpoint.len = len;
+    breakpoint.inst_size = static_cast<u32>(breakpoint.inst.size());
     Core::System::GetInstance().Memory().ReadBlock(
         *Core::System::GetInstance().Kernel().GetCurrentProcess(), addr, breakpoint.inst.data(),
         breakpoint.inst.size());
 
+    // Execution breakpoints are BKPT instructions patched into the code, which the JIT reports
+    // through its exception callback, so no per instruction checks are needed. The length of an
+    // execution breakpoint is its kind, 2 and 3 select a Thumb instruction.
     static constexpr std::array<u8, 4> btrap{0x70, 0x00, 0x20, 0xe1};
+    static constexpr std::array<u8, 2> thumb_btrap{0x00, 0xbe};
     if (type == BreakpointType::Execute) {
+        const std::span<const u8> trap =
+            (len == 2 || len == 3) ? std::span<const u8>{thumb_btrap} : std::span<const u8>{btrap};
+        breakpoint.inst_size = static_cast<u32>(trap.size());
         Core::System::GetInstance().Memory().WriteBlock(
-            *Core::System::GetInstance().Kernel().GetCurrentProcess(), addr, btrap.data(),
-            btrap.size());
-        Core::GetRunningCore().ClearInstructionCache();
+            *Core::System::GetInstance().Kernel().GetCurrentProcess(), addr, trap.data(),
+            trap.size());
+        Core::System::GetInstance().InvalidateCacheRange(addr, trap.size());
     }
     p.insert({addr, breakpoint});
 
@@ -1048,12 +1290,14 @@ void HandlePacket(Core::System& system) {
         return;
     }
 
-    if (!IsDataAvailable()) {
+    if (!ReadCommand()) {
         return;
     }
 
-    ReadCommand();
-    if (command_length == 0) {
+    if (command_buffer[0] == GDB_STUB_INTERRUPT) {
+        LOG_INFO(Debug_GDBStub, "gdb: found break command\n");
+        halt_loop = true;
+        SendSignal(current_thread, SIGTRAP);
         return;
     }
 
@@ -1096,6 +1340,12 @@ void HandlePacket(Core::System& system) {
     case 'M':
         WriteMemory();
         break;
+    case 'x':
+        ReadMemoryBinary();
+        break;
+    case 'X':
+        WriteMemoryBinary();
+        break;
     case 's':
         Step();
         return;
@@ -1211,6 +1461,14 @@ static void Init(u16 port) {
     } else {
         LOG_INFO(Debug_GDBStub, "Client connected.\n");
         saddr_client.sin_addr.s_addr = ntohl(saddr_client.sin_addr.s_addr);
+
+        {
+            std::scoped_lock lock{packet_mutex};
+            pending_packets.clear();
+            connection_lost = false;
+            command_pending = false;
+        }
+        reader_thread = std::thread(ReaderLoop, gdbserver_socket);
     }
 
     // Clean up temporary socket if it's still alive at this point.
@@ -1231,10 +1489,22 @@ void Shutdown() {
 
     LOG_INFO(Debug_GDBStub, "Stopping GDB ...");
     if (gdbserver_socket != -1) {
+        std::scoped_lock lock{send_mutex};
         shutdown(gdbserver_socket, SHUT_RDWR);
         gdbserver_socket = -1;
     }
 
+    // Shutting down the socket wakes the reader thread up
+    if (reader_thread.joinable()) {
+        reader_thread.join();
+    }
+    {
+        std::scoped_lock lock{packet_mutex};
+        pending_packets.clear();
+        connection_lost = false;
+        command_pending = false;
+    }
+
 #ifdef _WIN32
     WSACleanup();
 #endif
@@ -1250,6 +1520,10 @@ bool IsConnected() {
     return IsServerEnabled() && gdbserver_socket != -1;
 }
 
+bool HasPendingWork() {
+    return halt_loop || command_pending || (defer_start && !IsConnected());
+}
+
 bool GetCpuHaltFlag() {
     return halt_loop;
 }
@@ -0,0 +1,53 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <thread>
+#include "common/logging/log.h"
+#include "core/hle/kernel/async_executor.h"
+
+namespace Kernel {
+
+namespace {
+
+struct AsyncClassInfo {
+    const char* thread_name;
+    std::size_t num_workers;
+};
+
+// Storage requests always finish, so a few workers are enough to overlap them. Network requests
+// can block until the guest itself does something, e.g. accept waiting for a connect issued by
+// another guest thread, so that class gets a worker for every guest thread likely to use it.
+constexpr std::array<AsyncClassInfo, static_cast<std::size_t>(AsyncClass::Count)> ClassInfo{{
+    {"HLE:Storage", 4},
+    {"HLE:Network", 32},
+}};
+
+} // Anonymous namespace
+
+AsyncExecutor::AsyncExecutor() = default;
+
+AsyncExecutor::~AsyncExecutor() = default;
+
+void AsyncExecutor::QueueWork(AsyncClass async_class, Common::UniqueFunction<void> work) {
+    const auto index = static_cast<std::size_t>(async_class);
+    Common::ThreadWorker* worker;
+    {
+        std::scoped_lock lock{mutex};
+        if (!workers[index]) {
+            const AsyncClassInfo& info = ClassInfo[index];
+            std::size_t num_workers = info.num_workers;
+            if (async_class == AsyncClass::Storage) {
+                num_workers =
+                    std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, num_workers);
+            }
+            LOG_DEBUG(Kernel, "Creating {} workers for {}", num_workers, info.thread_name);
+            workers[index] = std::make_unique<Common::ThreadWorker>(num_workers, info.thread_name);
+        }
+        worker = workers[index].get();
+    }
+    worker->QueueWork(std::move(work));
+}
+
+} // namespace Kernel
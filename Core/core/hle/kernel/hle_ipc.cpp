@@ -121,6 +121,11 @@ std::shared_ptr<Event> HLERequestContext::SleepClientThread(
     return event;
 }
 
+void HLERequestContext::QueueAsyncWork(AsyncClass async_class,
+                                       Common::UniqueFunction<void> work) {
+    kernel.GetAsyncExecutor().QueueWork(async_class, std::move(work));
+}
+
 HLERequestContext::HLERequestContext() : kernel(Core::Global<KernelSystem>()) {}
 
 HLERequestContext::HLERequestContext(KernelSystem& kernel, std::shared_ptr<ServerSession> session,
@@ -7,6 +7,7 @@
 #include <boost/serialization/vector.hpp>
 #include "common/archives.h"
 #include "common/serialization/atomic.h"
+#include "core/hle/kernel/async_executor.h"
 #include "core/hle/kernel/client_port.h"
 #include "core/hle/kernel/config_mem.h"
 #include "core/hle/kernel/handle_table.h"
@@ -41,6 +42,7 @@ KernelSystem::KernelSystem(Memory::MemorySystem& memory, Core::Timing& timing,
     }
     timer_manager = std::make_unique<TimerManager>(timing);
     ipc_recorder = std::make_unique<IPCDebugger::Recorder>();
+    async_executor = std::make_unique<AsyncExecutor>();
     stored_processes.assign(num_cores, nullptr);
 
     next_thread_id = 1;
@@ -48,6 +50,7 @@ KernelSystem::KernelSystem(Memory::MemorySystem& memory, Core::Timing& timing,
 
 /// Shutdown the kernel
 KernelSystem::~KernelSystem() {
+    async_executor.reset();
     ResetThreadIDs();
 };
 
@@ -131,6 +134,10 @@ const TimerManager& KernelSystem::GetTimerManager() const {
     return *timer_manager;
 }
 
+AsyncExecutor& KernelSystem::GetAsyncExecutor() {
+    return *async_executor;
+}
+
 SharedPage::Handler& KernelSystem::GetSharedPageHandler() {
     return *shared_page_handler;
 }
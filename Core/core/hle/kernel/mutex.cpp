@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/string.hpp>
@@ -114,6 +115,17 @@ void Mutex::RemoveWaitingThread(Thread* thread) {
     UpdatePriority();
 }
 
+void Mutex::RemoveWokenThreads(std::span<Thread* const> threads) {
+    WaitObject::RemoveWokenThreads(threads);
+    for (Thread* thread : threads) {
+        if (std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                         [this](const auto& object) { return object.get() == this; })) {
+            thread->pending_mutexes.erase(SharedFrom(this));
+        }
+    }
+    UpdatePriority();
+}
+
 void Mutex::UpdatePriority() {
     if (!holding_thread)
         return;
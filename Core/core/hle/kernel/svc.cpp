@@ -5,12 +5,14 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <boost/container/small_vector.hpp>
 #include <fmt/format.h>
 #include "common/archives.h"
 #include "common/logging/log.h"
 #include "common/microprofile.h"
 #include "common/scm_rev.h"
 #include "common/settings.h"
+#include "common/tracing.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -379,6 +381,10 @@ enum class MapMemoryExFlag {
     MAPEXFLAGS_PRIVATE = (1 << 0),
 };
 
+/// Wait objects of a handle list, borrowed from the handle table for the duration of an SVC. Games
+/// wait on a handful of handles at a time, so longer lists are the only ones that allocate.
+using WaitObjectList = boost::container::small_vector<WaitObject*, 32>;
+
 class SVC : public SVCWrapper<SVC> {
 public:
     SVC(Core::System& system);
@@ -389,6 +395,12 @@ private:
     Kernel::KernelSystem& kernel;
     Memory::MemorySystem& memory;
 
+    // The wakeup callbacks of the wait SVCs hold no per wait state, so the waiting threads share
+    // these instead of allocating a new callback every time they block.
+    std::shared_ptr<WakeupCallback> sync_callback;
+    std::shared_ptr<WakeupCallback> sync_output_callback;
+    std::shared_ptr<WakeupCallback> ipc_callback;
+
     friend class SVCWrapper<SVC>;
 
     // ARM interfaces
@@ -414,6 +426,9 @@ private:
                                 s64 nano_seconds);
     Result ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_count,
                            Handle reply_target);
+    Result GetWaitObjects(WaitObjectList& objects, const HandleTable& handle_table,
+                          VAddr handles_address, s32 handle_count);
+    void SuspendOnObjects(Thread* thread, const WaitObjectList& objects);
     Result InvalidateProcessDataCache(Handle process_handle, VAddr address, u32 size);
     Result StoreProcessDataCache(Handle process_handle, VAddr address, u32 size);
     Result FlushProcessDataCache(Handle process_handle, VAddr address, u32 size);
@@ -763,7 +778,7 @@ private:
 
 /// Wait for a handle to synchronize, timeout after the specified nanoseconds
 Result SVC::WaitSynchronization1(Handle handle, s64 nano_seconds) {
-    auto object = kernel.GetCurrentProcess()->handle_table.Get<WaitObject>(handle);
+    WaitObject* object = kernel.GetCurrentProcess()->handle_table.GetBorrowed<WaitObject>(handle);
     Thread* thread = kernel.GetCurrentThreadManager().GetCurrentThread();
     R_UNLESS(object, ResultInvalidHandle);
 
@@ -773,14 +788,13 @@ Result SVC::WaitSynchronization1(Handle handle, s64 nano_seconds) {
     if (object->ShouldWait(thread)) {
         R_UNLESS(nano_seconds != 0, ResultTimeout);
 
-        thread->wait_objects = {object};
-        object->AddWaitingThread(SharedFrom(thread));
+        SuspendOnObjects(thread, {object});
         thread->status = ThreadStatus::WaitSynchAny;
 
         // Create an event to wake the thread up after the specified nanosecond delay has passed
         thread->WakeAfterDelay(nano_seconds);
 
-        thread->wakeup_callback = std::make_shared<SVC_SyncCallback>(false);
+        thread->wakeup_callback = sync_callback;
 
         system.PrepareReschedule();
 
@@ -808,23 +822,17 @@ Result SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle_cou
     // Check if 'handle_count' is invalid
     R_UNLESS(handle_count >= 0, ResultOutOfRange);
 
-    using ObjectPtr = std::shared_ptr<WaitObject>;
-    std::vector<ObjectPtr> objects(handle_count);
-
-    for (int i = 0; i < handle_count; ++i) {
-        Handle handle = memory.Read32(handles_address + i * sizeof(Handle));
-        auto object = kernel.GetCurrentProcess()->handle_table.Get<WaitObject>(handle);
-        R_UNLESS(object, ResultInvalidHandle);
-        objects[i] = object;
-    }
+    WaitObjectList objects;
+    R_TRY(GetWaitObjects(objects, kernel.GetCurrentProcess()->handle_table, handles_address,
+                         handle_count));
 
     if (wait_all) {
         bool all_available =
             std::all_of(objects.begin(), objects.end(),
-                        [thread](const ObjectPtr& object) { return !object->ShouldWait(thread); });
+                        [thread](WaitObject* object) { return !object->ShouldWait(thread); });
         if (all_available) {
             // We can acquire all objects right now, do so.
-            for (auto& object : objects)
+            for (WaitObject* object : objects)
                 object->Acquire(thread);
             // Note: In this case, the `out` parameter is not set,
             // and retains whatever value it had before.
@@ -841,16 +849,12 @@ Result SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle_cou
         thread->status = ThreadStatus::WaitSynchAll;
 
         // Add the thread to each of the objects' waiting threads.
-        for (auto& object : objects) {
-            object->AddWaitingThread(SharedFrom(thread));
-        }
-
-        thread->wait_objects = std::move(objects);
+        SuspendOnObjects(thread, objects);
 
         // Create an event to wake the thread up after the specified nanosecond delay has passed
         thread->WakeAfterDelay(nano_seconds);
 
-        thread->wakeup_callback = std::make_shared<SVC_SyncCallback>(false);
+        thread->wakeup_callback = sync_callback;
 
         system.PrepareReschedule();
 
@@ -861,14 +865,13 @@ Result SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle_cou
         return ResultTimeout;
     } else {
         // Find the first object that is acquirable in the provided list of objects
-        auto itr = std::find_if(objects.begin(), objects.end(), [thread](const ObjectPtr& object) {
+        auto itr = std::find_if(objects.begin(), objects.end(), [thread](WaitObject* object) {
             return !object->ShouldWait(thread);
         });
 
         if (itr != objects.end()) {
             // We found a ready object, acquire it and set the result value
-            WaitObject* object = itr->get();
-            object->Acquire(thread);
+            (*itr)->Acquire(thread);
             *out = static_cast<s32>(std::distance(objects.begin(), itr));
             return ResultSuccess;
         }
@@ -883,12 +886,7 @@ Result SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle_cou
         thread->status = ThreadStatus::WaitSynchAny;
 
         // Add the thread to each of the objects' waiting threads.
-        for (std::size_t i = 0; i < objects.size(); ++i) {
-            WaitObject* object = objects[i].get();
-            object->AddWaitingThread(SharedFrom(thread));
-        }
-
-        thread->wait_objects = std::move(objects);
+        SuspendOnObjects(thread, objects);
 
         // Note: If no handles and no timeout were given, then the thread will deadlock, this is
         // consistent with hardware behavior.
@@ -896,7 +894,7 @@ Result SVC::WaitSynchronizationN(s32* out, VAddr handles_address, s32 handle_cou
         // Create an event to wake the thread up after the specified nanosecond delay has passed
         thread->WakeAfterDelay(nano_seconds);
 
-        thread->wakeup_callback = std::make_shared<SVC_SyncCallback>(true);
+        thread->wakeup_callback = sync_output_callback;
 
         system.PrepareReschedule();
 
@@ -944,17 +942,10 @@ Result SVC::ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_count,
     // Check if 'handle_count' is invalid
     R_UNLESS(handle_count >= 0, ResultOutOfRange);
 
-    using ObjectPtr = std::shared_ptr<WaitObject>;
-    std::vector<ObjectPtr> objects(handle_count);
-
     std::shared_ptr<Process> current_process = kernel.GetCurrentProcess();
 
-    for (int i = 0; i < handle_count; ++i) {
-        Handle handle = memory.Read32(handles_address + i * sizeof(Handle));
-        auto object = current_process->handle_table.Get<WaitObject>(handle);
-        R_UNLESS(object, ResultInvalidHandle);
-        objects[i] = object;
-    }
+    WaitObjectList objects;
+    R_TRY(GetWaitObjects(objects, current_process->handle_table, handles_address, handle_count));
 
     // We are also sending a command reply.
     // Do not send a reply if the command id in the command buffer is 0xFFFF.
@@ -1001,13 +992,12 @@ Result SVC::ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_count,
     }
 
     // Find the first object that is acquirable in the provided list of objects
-    auto itr = std::find_if(objects.begin(), objects.end(), [thread](const ObjectPtr& object) {
-        return !object->ShouldWait(thread);
-    });
+    auto itr = std::find_if(objects.begin(), objects.end(),
+                            [thread](WaitObject* object) { return !object->ShouldWait(thread); });
 
     if (itr != objects.end()) {
         // We found a ready object, acquire it and set the result value
-        WaitObject* object = itr->get();
+        WaitObject* object = *itr;
         object->Acquire(thread);
         *index = static_cast<s32>(std::distance(objects.begin(), itr));
 
@@ -1023,14 +1013,9 @@ Result SVC::ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_count,
     thread->status = ThreadStatus::WaitSynchAny;
 
     // Add the thread to each of the objects' waiting threads.
-    for (std::size_t i = 0; i < objects.size(); ++i) {
-        WaitObject* object = objects[i].get();
-        object->AddWaitingThread(SharedFrom(thread));
-    }
-
-    thread->wait_objects = std::move(objects);
+    SuspendOnObjects(thread, objects);
 
-    thread->wakeup_callback = std::make_shared<SVC_IPCCallback>(system);
+    thread->wakeup_callback = ipc_callback;
 
     system.PrepareReschedule();
 
@@ -1041,6 +1026,30 @@ Result SVC::ReplyAndReceive(s32* index, VAddr handles_address, s32 handle_count,
     return ResultSuccess;
 }
 
+/// Looks up the wait objects of a guest handle list, failing on the first invalid handle
+Result SVC::GetWaitObjects(WaitObjectList& objects, const HandleTable& handle_table,
+                           VAddr handles_address, s32 handle_count) {
+    objects.resize(static_cast<std::size_t>(handle_count));
+    for (s32 i = 0; i < handle_count; ++i) {
+        const Handle handle = memory.Read32(handles_address + i * sizeof(Handle));
+        objects[i] = handle_table.GetBorrowed<WaitObject>(handle);
+        R_UNLESS(objects[i], ResultInvalidHandle);
+    }
+    return ResultSuccess;
+}
+
+/// Adds the thread to the waiting threads of the objects. This is the only point where the wait
+/// takes references to the objects, the thread reuses the storage of its previous wait for them.
+void SVC::SuspendOnObjects(Thread* thread, const WaitObjectList& objects) {
+    const std::shared_ptr<Thread> shared_thread = SharedFrom(thread);
+    thread->wait_objects.clear();
+    thread->wait_objects.reserve(objects.size());
+    for (WaitObject* object : objects) {
+        object->AddWaitingThread(shared_thread);
+        thread->wait_objects.push_back(SharedFrom(object));
+    }
+}
+
 /// Invalidates the specified cache range (stubbed as we do not emulate cache).
 Result SVC::InvalidateProcessDataCache(Handle process_handle, VAddr address, u32 size) {
     const std::shared_ptr<Process> process =
@@ -2360,6 +2369,7 @@ void SVC::CallSVC(u32 immediate) {
     LOG_TRACE(Kernel_SVC, "calling {}", info->name);
     if (info) {
         if (info->func) {
+            Common::Tracing::Scope scope{"SVC", info->name};
             (this->*(info->func))();
         } else {
             LOG_ERROR(Kernel_SVC, "unimplemented SVC function {}(..)", info->name);
@@ -2367,7 +2377,11 @@ void SVC::CallSVC(u32 immediate) {
     }
 }
 
-SVC::SVC(Core::System& system) : system(system), kernel(system.Kernel()), memory(system.Memory()) {}
+SVC::SVC(Core::System& system)
+    : system(system), kernel(system.Kernel()), memory(system.Memory()),
+      sync_callback(std::make_shared<SVC_SyncCallback>(false)),
+      sync_output_callback(std::make_shared<SVC_SyncCallback>(true)),
+      ipc_callback(std::make_shared<SVC_IPCCallback>(system)) {}
 
 u32 SVC::GetReg(std::size_t n) {
     return system.GetRunningCore().GetReg(static_cast<int>(n));
@@ -60,6 +60,11 @@ void Thread::serialize(Archive& ar, const unsigned int file_version) {
     ar & wait_address;
     ar & name;
     ar & wakeup_callback;
+    if (file_version >= 1) {
+        ar & wakeup_sequence;
+        ar & wakeup_event_pending;
+        ar & wakeup_event_userdata;
+    }
 }
 SERIALIZE_IMPL(Thread)
 
@@ -86,7 +91,7 @@ Thread* ThreadManager::GetCurrentThread() const {
 
 void Thread::Stop() {
     // Cancel any outstanding wakeup events for this thread
-    thread_manager.kernel.timing.UnscheduleEvent(thread_manager.ThreadWakeupEventType, thread_id);
+    CancelWakeup();
     thread_manager.wakeup_callback_table.erase(thread_id);
 
     // Clean up thread from ready queue
@@ -122,8 +127,6 @@ void ThreadManager::SwitchContext(Thread* new_thread) {
     Thread* previous_thread = GetCurrentThread();
     std::shared_ptr<Process> previous_process = nullptr;
 
-    Core::Timing& timing = kernel.timing;
-
     // Save context for previous thread
     if (previous_thread) {
         previous_process = previous_thread->owner_process.lock();
@@ -144,7 +147,7 @@ void ThreadManager::SwitchContext(Thread* new_thread) {
                    "Thread must be ready to become running.");
 
         // Cancel any outstanding wakeup events for this thread
-        timing.UnscheduleEvent(ThreadWakeupEventType, new_thread->thread_id);
+        new_thread->CancelWakeup();
 
         current_thread = SharedFrom(new_thread);
 
@@ -234,13 +237,30 @@ void ThreadManager::TerminateProcessThreads(std::shared_ptr<Process> process) {
     }
 }
 
-void ThreadManager::ThreadWakeupCallback(u64 thread_id, s64 cycles_late) {
-    std::shared_ptr<Thread> thread = SharedFrom(wakeup_callback_table.at(thread_id));
+void ThreadManager::ThreadWakeupCallback(u64 userdata, s64 cycles_late) {
+    const u32 thread_id = static_cast<u32>(userdata);
+    const u32 sequence = static_cast<u32>(userdata >> 32);
+
+    // The thread may have exited since the event was scheduled
+    const auto itr = wakeup_callback_table.find(thread_id);
+    if (itr == wakeup_callback_table.end()) {
+        return;
+    }
+    std::shared_ptr<Thread> thread = SharedFrom(itr->second);
     if (thread == nullptr) {
         LOG_CRITICAL(Kernel, "Callback fired for invalid thread {:08X}", thread_id);
         return;
     }
 
+    if (thread->wakeup_event_pending && thread->wakeup_event_userdata == userdata) {
+        thread->wakeup_event_pending = false;
+    }
+
+    // The wait this event was scheduled for has already ended
+    if (sequence != thread->wakeup_sequence) {
+        return;
+    }
+
     if (thread->status == ThreadStatus::WaitSynchAny ||
         thread->status == ThreadStatus::WaitSynchAll || thread->status == ThreadStatus::WaitArb ||
         thread->status == ThreadStatus::WaitHleEvent) {
@@ -263,10 +283,24 @@ void Thread::WakeAfterDelay(s64 nanoseconds, bool thread_safe_mode) {
     if (nanoseconds == -1)
         return;
     std::size_t core = thread_safe_mode ? core_id : std::numeric_limits<std::size_t>::max();
+    const u64 userdata = static_cast<u64>(wakeup_sequence) << 32 | thread_id;
 
     thread_manager.kernel.timing.ScheduleEvent(nsToCycles(nanoseconds),
-                                               thread_manager.ThreadWakeupEventType, thread_id,
-                                               core, thread_safe_mode);
+                                               thread_manager.ThreadWakeupEventType, userdata, core,
+                                               thread_safe_mode);
+    wakeup_event_pending = true;
+    wakeup_event_userdata = userdata;
+}
+
+void Thread::CancelWakeup() {
+    // Only the wakeups of finished waits are still pending here, which is rare enough for the scan
+    // of the event queues.
+    if (!wakeup_event_pending) {
+        return;
+    }
+    wakeup_event_pending = false;
+    thread_manager.kernel.timing.UnscheduleEvent(thread_manager.ThreadWakeupEventType,
+                                                 wakeup_event_userdata);
 }
 
 void Thread::ResumeFromWait() {
@@ -302,6 +336,7 @@ void Thread::ResumeFromWait() {
     }
 
     wakeup_callback = nullptr;
+    wakeup_sequence++;
 
     thread_manager.ready_queue.push_back(current_priority, this);
     status = ThreadStatus::Ready;
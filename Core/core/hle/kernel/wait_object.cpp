@@ -4,6 +4,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <boost/container/small_vector.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/vector.hpp>
@@ -47,61 +48,135 @@ void WaitObject::RemoveWaitingThread(Thread* thread) {
         waiting_threads.erase(itr);
 }
 
+void WaitObject::RemoveWokenThreads(std::span<Thread* const> threads) {
+    std::erase_if(waiting_threads, [this, threads](const std::shared_ptr<Thread>& thread) {
+        return std::binary_search(threads.begin(), threads.end(), thread.get()) &&
+               std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                            [this](const auto& object) { return object.get() == this; });
+    });
+}
+
+bool WaitObject::IsReadyToRun(const Thread* thread) const {
+    // The list of waiting threads must not contain threads that are not waiting to be awakened.
+    ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
+                   thread->status == ThreadStatus::WaitSynchAll ||
+                   thread->status == ThreadStatus::WaitHleEvent,
+               "Inconsistent thread statuses in waiting_threads");
+
+    if (ShouldWait(thread))
+        return false;
+
+    // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
+    // in ThreadStatus::WaitSynchAll and the rest of the objects it is waiting on are ready.
+    if (thread->status == ThreadStatus::WaitSynchAll) {
+        return std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                            [thread](const std::shared_ptr<WaitObject>& object) {
+                                return object->ShouldWait(thread);
+                            });
+    }
+    return true;
+}
+
 std::shared_ptr<Thread> WaitObject::GetHighestPriorityReadyThread() const {
     Thread* candidate = nullptr;
     u32 candidate_priority = ThreadPrioLowest + 1;
 
     for (const auto& thread : waiting_threads) {
-        // The list of waiting threads must not contain threads that are not waiting to be awakened.
-        ASSERT_MSG(thread->status == ThreadStatus::WaitSynchAny ||
-                       thread->status == ThreadStatus::WaitSynchAll ||
-                       thread->status == ThreadStatus::WaitHleEvent,
-                   "Inconsistent thread statuses in waiting_threads");
-
         if (thread->current_priority >= candidate_priority)
             continue;
 
-        if (ShouldWait(thread.get()))
-            continue;
-
-        // A thread is ready to run if it's either in ThreadStatus::WaitSynchAny or
-        // in ThreadStatus::WaitSynchAll and the rest of the objects it is waiting on are ready.
-        bool ready_to_run = true;
-        if (thread->status == ThreadStatus::WaitSynchAll) {
-            ready_to_run = std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
-                                        [&thread](const std::shared_ptr<WaitObject>& object) {
-                                            return object->ShouldWait(thread.get());
-                                        });
-        }
-
-        if (ready_to_run) {
+        if (IsReadyToRun(thread.get())) {
             candidate = thread.get();
             candidate_priority = thread->current_priority;
+            if (candidate_priority == ThreadPrioHighest)
+                break;
         }
     }
 
     return SharedFrom(candidate);
 }
 
+void WaitObject::WakeupThread(std::shared_ptr<Thread> thread) {
+    for (auto& object : ResumeWaitingThread(thread))
+        object->RemoveWaitingThread(thread.get());
+}
+
+std::vector<std::shared_ptr<WaitObject>> WaitObject::ResumeWaitingThread(
+    const std::shared_ptr<Thread>& thread) {
+    if (!thread->IsSleepingOnWaitAll()) {
+        Acquire(thread.get());
+    } else {
+        for (auto& object : thread->wait_objects) {
+            object->Acquire(thread.get());
+        }
+    }
+
+    // Invoke the wakeup callback before clearing the wait objects
+    if (thread->wakeup_callback)
+        thread->wakeup_callback->WakeUp(ThreadWakeupReason::Signal, thread, SharedFrom(this));
+
+    std::vector<std::shared_ptr<WaitObject>> wait_objects = std::move(thread->wait_objects);
+    thread->wait_objects.clear();
+
+    thread->ResumeFromWait();
+    return wait_objects;
+}
+
 void WaitObject::WakeupAllWaitingThreads() {
-    while (auto thread = GetHighestPriorityReadyThread()) {
-        if (!thread->IsSleepingOnWaitAll()) {
-            Acquire(thread.get());
-        } else {
-            for (auto& object : thread->wait_objects) {
-                object->Acquire(thread.get());
+    // Acquiring an object never makes it available to more threads, so a thread that can't run
+    // now won't be able to run later in this wake up either. Visiting the waiters once in priority
+    // order, oldest first within a priority, thus wakes the same threads in the same order as
+    // repeatedly picking the highest priority ready thread, without rescanning the list.
+    struct Waiter {
+        std::shared_ptr<Thread> thread;
+        u32 priority;
+    };
+    boost::container::small_vector<Waiter, 16> waiters;
+    waiters.reserve(waiting_threads.size());
+    for (const auto& thread : waiting_threads) {
+        waiters.push_back({thread, thread->current_priority});
+    }
+    std::stable_sort(waiters.begin(), waiters.end(),
+                     [](const Waiter& a, const Waiter& b) { return a.priority < b.priority; });
+
+    // The woken up threads are removed from the waiting lists once all of them were chosen, with
+    // one pass over the list of each object they waited for.
+    boost::container::small_vector<Thread*, 16> woken_threads;
+    boost::container::small_vector<std::shared_ptr<WaitObject>, 16> released_objects;
+    for (const Waiter& waiter : waiters) {
+        Thread* thread = waiter.thread.get();
+        // Stop if waking up a thread changed the priority of another one through a mutex, the
+        // remaining threads are handled below.
+        if (thread->current_priority != waiter.priority)
+            break;
+
+        // Skip threads that were woken up or stopped waiting in the meantime.
+        if (std::none_of(thread->wait_objects.begin(), thread->wait_objects.end(),
+                         [this](const auto& object) { return object.get() == this; }))
+            continue;
+
+        if (IsReadyToRun(thread)) {
+            for (auto& object : ResumeWaitingThread(waiter.thread)) {
+                released_objects.push_back(std::move(object));
             }
+            woken_threads.push_back(thread);
         }
+    }
 
-        // Invoke the wakeup callback before clearing the wait objects
-        if (thread->wakeup_callback)
-            thread->wakeup_callback->WakeUp(ThreadWakeupReason::Signal, thread, SharedFrom(this));
-
-        for (auto& object : thread->wait_objects)
-            object->RemoveWaitingThread(thread.get());
-        thread->wait_objects.clear();
+    if (!woken_threads.empty()) {
+        std::ranges::sort(woken_threads);
+        const auto address = [](const std::shared_ptr<WaitObject>& object) { return object.get(); };
+        std::ranges::sort(released_objects, std::less{}, address);
+        const auto duplicates = std::ranges::unique(released_objects, std::equal_to{}, address);
+        released_objects.erase(duplicates.begin(), duplicates.end());
+        for (const auto& object : released_objects) {
+            object->RemoveWokenThreads({woken_threads.data(), woken_threads.size()});
+        }
+    }
 
-        thread->ResumeFromWait();
+    // Catches threads whose priority changed and waiters added by the wakeup callbacks.
+    while (auto thread = GetHighestPriorityReadyThread()) {
+        WakeupThread(std::move(thread));
     }
 
     if (hle_notifier)
@@ -5,6 +5,8 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstring>
+#include <mutex>
+#include <thread>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <fmt/format.h>
@@ -14,6 +16,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/task_scheduler.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/ncch_container.h"
@@ -760,11 +763,32 @@ std::string GetMediaTitlePath(Service::FS::MediaType media_type) {
     return "";
 }
 
+namespace {
+
+constexpr u32 TITLE_SCAN_CACHE_MAGIC = 0x42445441; // "ATDB"
+constexpr u32 TITLE_SCAN_CACHE_VERSION = 1;
+
+std::string GetTitleScanCachePath() {
+    return FileUtil::GetUserPath(FileUtil::UserPath::CacheDir) + "am_title_scan.bin";
+}
+
+} // Anonymous namespace
+
 void Module::ScanForTitles(Service::FS::MediaType media_type) {
     am_title_list[static_cast<u32>(media_type)].clear();
 
     std::string title_path = GetMediaTitlePath(media_type);
 
+    struct ScannedTitle {
+        u64 tid;
+        std::string content_path;
+        u64 size;
+        s64 modification_time;
+        bool valid;
+        bool parsed;
+    };
+    std::vector<ScannedTitle> titles;
+
     FileUtil::FSTEntry entries;
     FileUtil::ScanDirectoryTree(title_path, entries, 1);
     for (const FileUtil::FSTEntry& tid_high : entries.children) {
@@ -772,29 +796,144 @@ void Module::ScanForTitles(Service::FS::MediaType media_type) {
             std::string tid_string = tid_high.virtualName + tid_low.virtualName;
 
             if (tid_string.length() == TITLE_ID_VALID_LENGTH) {
-                const u64 tid = std::stoull(tid_string, nullptr, 16);
-
-                if (tid & TWL_TITLE_ID_FLAG) {
-                    // TODO(PabloMK7) Move to TWL Nand, for now only check that
-                    // the contents exists in CTR Nand as this is a SRL file
-                    // instead of NCCH.
-                    if (FileUtil::Exists(GetTitleContentPath(media_type, tid))) {
-                        am_title_list[static_cast<u32>(media_type)].push_back(tid);
-                    }
-                } else {
-                    FileSys::NCCHContainer container(GetTitleContentPath(media_type, tid));
-                    if (container.Load() == Loader::ResultStatus::Success) {
-                        am_title_list[static_cast<u32>(media_type)].push_back(tid);
-                    }
-                }
+                titles.push_back({.tid = std::stoull(tid_string, nullptr, 16)});
             }
         }
     }
+
+    // Resolving the content of a title reads its TMD, so check the titles in parallel. Contents
+    // that loaded successfully during a previous scan and still have the same size and
+    // modification time are not parsed again. Parsing the NCCH headers sets up the keys in the
+    // global AES key slots, so only one content is parsed at a time.
+    std::mutex ncch_load_mutex;
+    const auto check_title = [this, media_type, &ncch_load_mutex](ScannedTitle& title) {
+        title.content_path = GetTitleContentPath(media_type, title.tid);
+
+        if (title.tid & TWL_TITLE_ID_FLAG) {
+            // TODO(PabloMK7) Move to TWL Nand, for now only check that
+            // the contents exists in CTR Nand as this is a SRL file
+            // instead of NCCH.
+            title.valid = FileUtil::Exists(title.content_path);
+            return;
+        }
+
+        if (!FileUtil::Exists(title.content_path)) {
+            return;
+        }
+
+        title.size = FileUtil::GetSize(title.content_path);
+        title.modification_time = FileUtil::GetModificationTime(title.content_path);
+        const auto it = title_scan_cache.find(title.content_path);
+        if (title.modification_time != 0 && it != title_scan_cache.end() &&
+            it->second.size == title.size &&
+            it->second.modification_time == title.modification_time) {
+            title.valid = true;
+            return;
+        }
+
+        std::scoped_lock lock{ncch_load_mutex};
+        FileSys::NCCHContainer container(title.content_path);
+        title.valid = container.Load() == Loader::ResultStatus::Success;
+        title.parsed = true;
+    };
+
+    if (titles.size() > 1) {
+        const std::size_t num_workers =
+            std::min<std::size_t>(titles.size(), std::max(std::thread::hardware_concurrency(), 1U));
+        Common::TaskGroup workers("AM title scan", num_workers);
+        for (ScannedTitle& title : titles) {
+            workers.QueueWork([&check_title, &title] { check_title(title); });
+        }
+        workers.Wait();
+    } else {
+        std::ranges::for_each(titles, check_title);
+    }
+
+    std::size_t num_parsed = 0;
+    for (const ScannedTitle& title : titles) {
+        if (title.parsed) {
+            num_parsed++;
+            if (title.valid && title.modification_time != 0) {
+                title_scan_cache[title.content_path] = {title.size, title.modification_time};
+            } else {
+                title_scan_cache.erase(title.content_path);
+            }
+            title_scan_cache_dirty = true;
+        }
+        if (title.valid) {
+            am_title_list[static_cast<u32>(media_type)].push_back(title.tid);
+        }
+    }
+
+    LOG_DEBUG(Service_AM, "Found {} titles in media type {}, parsed {} new or changed contents",
+              am_title_list[static_cast<u32>(media_type)].size(), media_type, num_parsed);
 }
 
 void Module::ScanForAllTitles() {
+    if (title_scan_cache.empty()) {
+        LoadTitleScanCache();
+    }
     ScanForTitles(Service::FS::MediaType::NAND);
     ScanForTitles(Service::FS::MediaType::SDMC);
+    SaveTitleScanCache();
+}
+
+void Module::LoadTitleScanCache() {
+    FileUtil::IOFile file(GetTitleScanCachePath(), "rb");
+    if (!file.IsOpen()) {
+        return;
+    }
+
+    u32 magic{};
+    u32 version{};
+    u32 count{};
+    if (file.ReadArray(&magic, 1) != 1 || magic != TITLE_SCAN_CACHE_MAGIC ||
+        file.ReadArray(&version, 1) != 1 || version != TITLE_SCAN_CACHE_VERSION ||
+        file.ReadArray(&count, 1) != 1) {
+        LOG_WARNING(Service_AM, "Ignoring invalid title scan cache");
+        return;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        u32 path_length{};
+        TitleScanCacheEntry entry{};
+        if (file.ReadArray(&path_length, 1) != 1) {
+            break;
+        }
+        std::string path(path_length, '\0');
+        if (file.ReadBytes(path.data(), path_length) != path_length ||
+            file.ReadArray(&entry.size, 1) != 1 ||
+            file.ReadArray(&entry.modification_time, 1) != 1) {
+            LOG_WARNING(Service_AM, "Title scan cache is truncated");
+            break;
+        }
+        title_scan_cache.emplace(std::move(path), entry);
+    }
+}
+
+void Module::SaveTitleScanCache() {
+    if (!title_scan_cache_dirty) {
+        return;
+    }
+    title_scan_cache_dirty = false;
+
+    const std::string path = GetTitleScanCachePath();
+    FileUtil::CreateFullPath(path);
+    FileUtil::IOFile file(path, "wb");
+    if (!file.IsOpen()) {
+        LOG_ERROR(Service_AM, "Unable to open title scan cache {}", path);
+        return;
+    }
+
+    file.WriteObject(TITLE_SCAN_CACHE_MAGIC);
+    file.WriteObject(TITLE_SCAN_CACHE_VERSION);
+    file.WriteObject(static_cast<u32>(title_scan_cache.size()));
+    for (const auto& [content_path, entry] : title_scan_cache) {
+        file.WriteObject(static_cast<u32>(content_path.size()));
+        file.WriteBytes(content_path.data(), content_path.size());
+        file.WriteObject(entry.size);
+        file.WriteObject(entry.modification_time);
+    }
 }
 
 Module::Interface::Interface(std::shared_ptr<Module> am, const char* name, u32 max_session)
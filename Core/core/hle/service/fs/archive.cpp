@@ -429,6 +429,18 @@ void ArchiveManager::RegisterSelfNCCH(Loader::AppLoader& app_loader) {
     factory->Register(app_loader);
 }
 
+void ArchiveManager::RegisterSelfNCCH(u64 program_id, FileSys::NCCHData data) {
+    auto itr = id_code_map.find(ArchiveIdCode::SelfNCCH);
+    if (itr == id_code_map.end()) {
+        LOG_ERROR(Service_FS,
+                  "Could not register a new NCCH because the SelfNCCH archive hasn't been created");
+        return;
+    }
+
+    auto* factory = static_cast<FileSys::ArchiveFactory_SelfNCCH*>(itr->second.get());
+    factory->Register(program_id, std::move(data));
+}
+
 void ArchiveManager::RegisterArticSaveDataSource(
     std::shared_ptr<Network::ArticBase::Client>& client) {
     if (!sd_savedata_source.get()) {
@@ -708,7 +708,8 @@ void HTTP_C::ReceiveDataImpl(Kernel::HLERequestContext& ctx, bool timeout) {
             LOG_DEBUG(Service_HTTP, "Receive: buffer_size= {}, total_copied={}, total_body={}",
                       async_data->buffer_size, http_context.current_copied_data,
                       http_context.response.body.size());
-        });
+        },
+        true, Kernel::AsyncClass::Network);
 }
 
 void HTTP_C::SetProxyDefault(Kernel::HLERequestContext& ctx) {
@@ -1475,7 +1476,8 @@ void HTTP_C::GetResponseHeaderImpl(Kernel::HLERequestContext& ctx, bool timeout)
             rb.Push(ResultSuccess);
             rb.Push(copied_size);
             rb.PushMappedBuffer(*async_data->value_buffer);
-        });
+        },
+        true, Kernel::AsyncClass::Network);
 }
 
 void HTTP_C::GetResponseStatusCode(Kernel::HLERequestContext& ctx) {
@@ -1546,7 +1548,8 @@ void HTTP_C::GetResponseStatusCodeImpl(Kernel::HLERequestContext& ctx, bool time
                                    0);
             rb.Push(ResultSuccess);
             rb.Push(response_code);
-        });
+        },
+        true, Kernel::AsyncClass::Network);
 }
 
 void HTTP_C::AddTrustedRootCA(Kernel::HLERequestContext& ctx) {
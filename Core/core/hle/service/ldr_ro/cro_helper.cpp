@@ -153,6 +153,17 @@ VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
     if (!GetField(ExportTreeNum))
         return 0;
 
+    if (export_index) {
+        if (const auto* symbols = export_index->Find(module_address)) {
+            const auto it = symbols->find(name);
+            return it != symbols->end() ? it->second : 0;
+        }
+    }
+
+    return FindExportNamedSymbolInTree(name);
+}
+
+VAddr CROHelper::FindExportNamedSymbolInTree(const std::string& name) const {
     std::size_t len = name.size();
     ExportTreeEntry entry;
     GetEntry(system.Memory(), 0, entry);
@@ -195,6 +206,28 @@ VAddr CROHelper::FindExportNamedSymbol(const std::string& name) const {
     return SegmentTagToAddress(symbol_entry.symbol_position);
 }
 
+void CROHelper::BuildExportSymbolIndex() {
+    ExportSymbolIndex::SymbolMap symbols;
+    if (GetField(ExportTreeNum)) {
+        u32 export_strings_size = GetField(ExportStringsSize);
+        u32 export_named_symbol_num = GetField(ExportNamedSymbolNum);
+        symbols.reserve(export_named_symbol_num);
+        for (u32 i = 0; i < export_named_symbol_num; ++i) {
+            ExportNamedSymbolEntry entry;
+            GetEntry(system.Memory(), i, entry);
+            std::string name = system.Memory().ReadCString(entry.name_offset, export_strings_size);
+            if (symbols.contains(name))
+                continue;
+
+            // Resolves through the tree once, so that the index answers exactly like the tree.
+            VAddr symbol_address = FindExportNamedSymbolInTree(name);
+            if (symbol_address != 0)
+                symbols.emplace(std::move(name), symbol_address);
+        }
+    }
+    export_index->Add(module_address, std::move(symbols));
+}
+
 Result CROHelper::RebaseHeader(u32 cro_size) {
     Result error = CROFormatError(0x11);
 
@@ -759,10 +792,11 @@ Result CROHelper::ApplyImportNamedSymbol(VAddr crs_address) {
                                   sizeof(ExternalRelocationEntry));
 
         if (!relocation_entry.is_batch_resolved) {
+            std::string symbol_name =
+                system.Memory().ReadCString(entry.name_offset, import_strings_size);
             Result result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
-                    std::string symbol_name =
-                        system.Memory().ReadCString(entry.name_offset, import_strings_size);
+                process, system, export_index, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol(symbol_name);
 
                     if (symbol_address != 0) {
@@ -863,7 +897,8 @@ Result CROHelper::ApplyModuleImport(VAddr crs_address) {
             system.Memory().ReadCString(entry.name_offset, import_strings_size);
 
         Result result = ForEachAutoLinkCRO(
-            process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+            process, system, export_index, crs_address,
+            [&](CROHelper source) -> ResultVal<bool> {
                 if (want_cro_name == source.ModuleName()) {
                     LOG_INFO(Service_LDR, "CRO \"{}\" imports {} indexed symbols from \"{}\"",
                              ModuleName(), entry.import_indexed_symbol_num, source.ModuleName());
@@ -1074,7 +1109,8 @@ Result CROHelper::ApplyExitRelocations(VAddr crs_address) {
         if (system.Memory().ReadCString(entry.name_offset, import_strings_size) ==
             "__aeabi_atexit") {
             Result result = ForEachAutoLinkCRO(
-                process, system, crs_address, [&](CROHelper source) -> ResultVal<bool> {
+                process, system, export_index, crs_address,
+                [&](CROHelper source) -> ResultVal<bool> {
                     u32 symbol_address = source.FindExportNamedSymbol("nnroAeabiAtexit_");
 
                     if (symbol_address != 0) {
@@ -1225,10 +1261,16 @@ Result CROHelper::Rebase(VAddr crs_address, u32 cro_size, VAddr data_segment_add
         }
     }
 
+    if (export_index)
+        BuildExportSymbolIndex();
+
     return ResultSuccess;
 }
 
 void CROHelper::Unrebase(bool is_crs) {
+    if (export_index)
+        export_index->Remove(module_address);
+
     UnrebaseImportAnonymousSymbolTable();
     UnrebaseImportIndexedSymbolTable();
     UnrebaseImportNamedSymbolTable();
@@ -1305,7 +1347,7 @@ Result CROHelper::Link(VAddr crs_address, bool link_on_load_bug_fix) {
     }
 
     // Exports symbols to other modules
-    result = ForEachAutoLinkCRO(process, system, crs_address,
+    result = ForEachAutoLinkCRO(process, system, export_index, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     Result result = ApplyExportNamedSymbol(target);
                                     if (result.IsError())
@@ -1350,7 +1392,7 @@ Result CROHelper::Unlink(VAddr crs_address) {
 
     // Resets all symbols in other modules imported from this module
     // Note: the RO service seems only searching in auto-link modules
-    result = ForEachAutoLinkCRO(process, system, crs_address,
+    result = ForEachAutoLinkCRO(process, system, export_index, crs_address,
                                 [this](CROHelper target) -> ResultVal<bool> {
                                     Result result = ResetExportNamedSymbol(target);
                                     if (result.IsError())
@@ -127,7 +127,7 @@ void RO::Initialize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    CROHelper crs(crs_address, *process, system);
+    CROHelper crs(crs_address, *process, system, &slot->export_index);
     crs.InitCRS();
 
     result = crs.Rebase(0, crs_size, 0, 0, 0, 0, true);
@@ -261,7 +261,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
         return;
     }
 
-    CROHelper cro(cro_address, *process, system);
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
 
     result = cro.VerifyHash(cro_size, crr_address);
     if (result.IsError()) {
@@ -287,6 +287,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
     result = cro.Link(slot->loaded_crs, link_on_load_bug_fix);
     if (result.IsError()) {
         LOG_ERROR(Service_LDR, "Error linking CRO {:08X}", result.raw);
+        slot->export_index.Remove(cro_address);
         process->Unmap(cro_address, cro_buffer_ptr, cro_size, Kernel::VMAPermission::ReadWrite,
                        true);
         rb.Push(result);
@@ -303,6 +304,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
                                 cro_size - fix_size, Kernel::VMAPermission::ReadWrite, true);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error unmapping memory block {:08X}", result.raw);
+            slot->export_index.Remove(cro_address);
             process->Unmap(cro_address, cro_buffer_ptr, cro_size, Kernel::VMAPermission::ReadWrite,
                            true);
             rb.Push(result);
@@ -317,6 +319,7 @@ void RO::LoadCRO(Kernel::HLERequestContext& ctx, bool link_on_load_bug_fix) {
                                                     Kernel::VMAPermission::ReadExecute);
         if (result.IsError()) {
             LOG_ERROR(Service_LDR, "Error reprotecting memory block {:08X}", result.raw);
+            slot->export_index.Remove(cro_address);
             process->Unmap(cro_address, cro_buffer_ptr, cro_size, Kernel::VMAPermission::ReadWrite,
                            true);
             rb.Push(result);
@@ -343,11 +346,11 @@ void RO::UnloadCRO(Kernel::HLERequestContext& ctx) {
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}, zero={}, cro_buffer_ptr=0x{:08X}",
               cro_address, zero, cro_buffer_ptr);
 
-    CROHelper cro(cro_address, *process, system);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
+
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -410,11 +413,11 @@ void RO::LinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}", cro_address);
 
-    CROHelper cro(cro_address, *process, system);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
+
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -450,11 +453,11 @@ void RO::UnlinkCRO(Kernel::HLERequestContext& ctx) {
 
     LOG_DEBUG(Service_LDR, "called, cro_address=0x{:08X}", cro_address);
 
-    CROHelper cro(cro_address, *process, system);
-
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
 
     ClientSlot* slot = GetSessionData(ctx.Session());
+    CROHelper cro(cro_address, *process, system, &slot->export_index);
+
     if (slot->loaded_crs == 0) {
         LOG_ERROR(Service_LDR, "Not initialized");
         rb.Push(ERROR_NOT_INITIALIZED);
@@ -499,7 +502,7 @@ void RO::Shutdown(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    CROHelper crs(slot->loaded_crs, *process, system);
+    CROHelper crs(slot->loaded_crs, *process, system, &slot->export_index);
     crs.Unrebase(true);
 
     Result result = ResultSuccess;
@@ -33,7 +33,18 @@ void NWM_UDS::serialize(Archive& ar, const unsigned int) {
     ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
     ar & node_map;
     ar & connection_event;
-    ar & received_beacons;
+    // Beacons are stored as a list in the archive to keep older save states loadable.
+    std::list<Network::WifiPacket> beacons(received_beacons.begin(), received_beacons.end());
+    ar & beacons;
+    if (Archive::is_loading::value) {
+        received_beacons.clear();
+        while (beacons.size() > MaxBeaconFrames) {
+            beacons.pop_front();
+        }
+        for (auto& beacon : beacons) {
+            received_beacons.push_back(std::move(beacon));
+        }
+    }
     // wifi_packet_received set in constructor
 }
 
@@ -44,32 +55,29 @@ enum {
 };
 } // namespace ErrCodes
 
-// Number of beacons to store before we start dropping the old ones.
-// TODO(Subv): Find a more accurate value for this limit.
-constexpr std::size_t MaxBeaconFrames = 15;
-
 // Network node id used when a SecureData packet is addressed to every connected node.
 constexpr u16 BroadcastNetworkNodeId = 0xFFFF;
 
 // The Host has always dest_node_id 1
 constexpr u16 HostDestNodeId = 1;
 
-std::list<Network::WifiPacket> NWM_UDS::GetReceivedBeacons(const MacAddress& sender) {
+BeaconList NWM_UDS::GetReceivedBeacons(const MacAddress& sender) {
     std::scoped_lock lock(beacon_mutex);
+    BeaconList filtered_list;
     if (sender != Network::BroadcastMac) {
-        std::list<Network::WifiPacket> filtered_list;
         const auto beacon = std::find_if(received_beacons.begin(), received_beacons.end(),
                                          [&sender](const Network::WifiPacket& packet) {
                                              return packet.transmitter_address == sender;
                                          });
         if (beacon != received_beacons.end()) {
-            filtered_list.push_back(*beacon);
+            filtered_list.push_back(std::move(*beacon));
             // TODO(B3N30): Check if the complete deque is cleared or just the fetched entries
             received_beacons.erase(beacon);
         }
         return filtered_list;
     }
-    return std::move(received_beacons);
+    filtered_list.swap(received_beacons);
+    return filtered_list;
 }
 
 /// Sends a WifiPacket to the room we're currently connected to.
@@ -145,21 +153,29 @@ void NWM_UDS::HandleNodeMapPacket(const Network::WifiPacket& packet) {
 
 void NWM_UDS::HandleBeaconFrame(const Network::WifiPacket& packet) {
     std::scoped_lock lock(beacon_mutex);
-    const auto unique_beacon =
-        std::find_if(received_beacons.begin(), received_beacons.end(),
-                     [&packet](const Network::WifiPacket& new_packet) {
-                         return new_packet.transmitter_address == packet.transmitter_address;
-                     });
-    if (unique_beacon != received_beacons.end()) {
-        // We already have a beacon from the same mac in the deque, remove the old one;
-        received_beacons.erase(unique_beacon);
+    auto slot = std::find_if(received_beacons.begin(), received_beacons.end(),
+                             [&packet](const Network::WifiPacket& old_packet) {
+                                 return old_packet.transmitter_address ==
+                                        packet.transmitter_address;
+                             });
+    if (slot == received_beacons.end() && received_beacons.size() == MaxBeaconFrames) {
+        // The buffer is full, recycle the oldest beacon.
+        slot = received_beacons.begin();
     }
 
-    received_beacons.emplace_back(packet);
+    if (slot == received_beacons.end()) {
+        received_beacons.push_back(packet);
+        return;
+    }
 
-    // Discard old beacons if the buffer is full.
-    if (received_beacons.size() > MaxBeaconFrames)
-        received_beacons.pop_front();
+    // Move the replaced entry to the back and overwrite it in place, reusing its data buffer.
+    std::rotate(slot, slot + 1, received_beacons.end());
+    auto& beacon = received_beacons.back();
+    beacon.type = packet.type;
+    beacon.data.assign(packet.data.begin(), packet.data.end());
+    beacon.transmitter_address = packet.transmitter_address;
+    beacon.destination_address = packet.destination_address;
+    beacon.channel = packet.channel;
 }
 
 void NWM_UDS::HandleAssociationResponseFrame(const Network::WifiPacket& packet) {
@@ -320,6 +336,12 @@ void NWM_UDS::HandleEAPoLPacket(const Network::WifiPacket& packet) {
 }
 
 void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
+    if (packet.data.size() < sizeof(LLCHeader) + sizeof(SecureDataHeader)) {
+        LOG_ERROR(Service_NWM, "Received truncated SecureDataPacket of size {}",
+                  packet.data.size());
+        return;
+    }
+
     const auto secure_data = ParseSecureDataHeader(packet.data);
     std::scoped_lock lock{connection_status_mutex, system.Kernel().GetHLELock()};
 
@@ -373,8 +395,19 @@ void NWM_UDS::HandleSecureDataPacket(const Network::WifiPacket& packet) {
         channel_info->second.network_node_id != secure_data.src_node_id)
         return;
 
-    // Add the received packet to the data queue.
-    channel_info->second.received_packets.emplace_back(packet.data);
+    const std::span payload = GetSecureDataPayload(packet.data, secure_data);
+    auto& bind_node = channel_info->second;
+    if (bind_node.pending_bytes + payload.size() > bind_node.recv_buffer_size) {
+        // The receive buffer of this bind node is full, the frame is dropped.
+        LOG_DEBUG(Service_NWM, "Dropped SecureDataPacket, bind node {} receive buffer is full",
+                  bind_node.bind_node_id);
+        return;
+    }
+
+    // Add the received payload to the data queue.
+    bind_node.pending_bytes += payload.size();
+    bind_node.received_packets.push_back(
+        {secure_data.src_node_id, std::vector<u8>(payload.begin(), payload.end())});
 
     // Signal the data event. We can do this directly because we locked hle_lock
     channel_info->second.event->Signal();
@@ -797,7 +830,8 @@ void NWM_UDS::Bind(Kernel::HLERequestContext& ctx) {
 
     ASSERT(channel_data.find(data_channel) == channel_data.end());
     // TODO(B3N30): Support more than one bind node per channel.
-    channel_data[data_channel] = {bind_node_id, data_channel, network_node_id, event};
+    channel_data[data_channel] = {bind_node_id, data_channel, network_node_id, event,
+                                  recv_buffer_size};
 
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 2);
     rb.Push(ResultSuccess);
@@ -1203,9 +1237,7 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
     }
 
     const auto& next_packet = channel->second.received_packets.front();
-
-    auto secure_data = ParseSecureDataHeader(next_packet);
-    auto data_size = secure_data.GetActualDataSize();
+    const auto data_size = static_cast<u32>(next_packet.payload.size());
 
     if (data_size > max_out_buff_size) {
         IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
@@ -1218,14 +1250,14 @@ void NWM_UDS::PullPacket(Kernel::HLERequestContext& ctx) {
 
     std::vector<u8> output_buffer(buff_size);
     // Write the actual data.
-    std::memcpy(output_buffer.data(),
-                next_packet.data() + sizeof(LLCHeader) + sizeof(SecureDataHeader), data_size);
+    std::memcpy(output_buffer.data(), next_packet.payload.data(), data_size);
 
     rb.Push(ResultSuccess);
     rb.Push<u32>(data_size);
-    rb.Push<u16>(secure_data.src_node_id);
+    rb.Push<u16>(next_packet.src_node_id);
     rb.PushStaticBuffer(std::move(output_buffer), 0);
 
+    channel->second.pending_bytes -= data_size;
     channel->second.received_packets.pop_front();
 }
 
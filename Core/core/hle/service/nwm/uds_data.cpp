@@ -286,6 +286,16 @@ SecureDataHeader ParseSecureDataHeader(std::span<const u8> data) {
     return header;
 }
 
+std::span<const u8> GetSecureDataPayload(std::span<const u8> data, const SecureDataHeader& header) {
+    constexpr std::size_t HeadersSize = sizeof(LLCHeader) + sizeof(SecureDataHeader);
+    if (data.size() <= HeadersSize || header.protocol_size <= sizeof(SecureDataHeader)) {
+        return {};
+    }
+    const std::size_t size = std::min<std::size_t>(header.GetActualDataSize(),
+                                                   data.size() - HeadersSize);
+    return data.subspan(HeadersSize, size);
+}
+
 std::vector<u8> GenerateEAPoLStartFrame(u16 association_id, const NodeInfo& node_info) {
     EAPoLStartPacket eapol_start{};
     eapol_start.association_id = association_id;
@@ -1022,7 +1022,8 @@ void SOC_U::Accept(Kernel::HLERequestContext& ctx) {
             rb.Push(ResultSuccess);
             rb.Push(async_data->ret);
             rb.PushStaticBuffer(std::move(ctr_addr_buf), 0);
-        });
+        },
+        true, Kernel::AsyncClass::Network);
 }
 
 void SOC_U::SockAtMark(Kernel::HLERequestContext& ctx) {
@@ -1377,7 +1378,7 @@ void SOC_U::RecvFromOther(Kernel::HLERequestContext& ctx) {
             rb.PushStaticBuffer(std::move(async_data->addr_buff), 0);
             rb.PushMappedBuffer(*async_data->buffer);
         },
-        needs_async);
+        needs_async, Kernel::AsyncClass::Network);
 }
 
 void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
@@ -1500,7 +1501,7 @@ void SOC_U::RecvFrom(Kernel::HLERequestContext& ctx) {
             rb.PushStaticBuffer(std::move(async_data->output_buff), 0);
             rb.PushStaticBuffer(std::move(async_data->addr_buff), 1);
         },
-        needs_async);
+        needs_async, Kernel::AsyncClass::Network);
 }
 
 void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
@@ -1577,7 +1578,7 @@ void SOC_U::Poll(Kernel::HLERequestContext& ctx) {
             LOG_POLL(Service_SOC, "called, fd_count={}, ret={}", async_data->nfds,
                      static_cast<s32>(async_data->ret));
         },
-        timeout != 0);
+        timeout != 0, Kernel::AsyncClass::Network);
 }
 
 void SOC_U::GetSockName(Kernel::HLERequestContext& ctx) {
@@ -1817,7 +1818,8 @@ void SOC_U::Connect(Kernel::HLERequestContext& ctx) {
             IPC::RequestBuilder rb(ctx, 0x06, 2, 0);
             rb.Push(ResultSuccess);
             rb.Push(async_data->ret);
-        });
+        },
+        true, Kernel::AsyncClass::Network);
 }
 
 void SOC_U::InitializeSockets(Kernel::HLERequestContext& ctx) {
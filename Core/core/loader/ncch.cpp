@@ -12,7 +12,9 @@
 #include "common/settings.h"
 #include "common/string_util.h"
 #include "common/swap.h"
+#include "common/task_scheduler.h"
 #include "core/core.h"
+#include "core/file_sys/archive_selfncch.h"
 #include "core/file_sys/ncch_container.h"
 #include "core/file_sys/title_metadata.h"
 #include "core/hle/kernel/kernel.h"
@@ -290,11 +292,20 @@ ResultStatus AppLoader_NCCH::Load(std::shared_ptr<Kernel::Process>& process) {
 
     is_loaded = true; // Set state to loaded
 
+    // The RomFS, icon, logo and banner do not depend on the executable, read them while the code
+    // section is decrypted and decompressed. They are only registered once the executable loaded.
+    FileSys::NCCHData self_ncch_data;
+    Common::TaskGroup boot_workers{"NCCH boot", 1};
+    boot_workers.QueueWork([this, &self_ncch_data] {
+        self_ncch_data = FileSys::ArchiveFactory_SelfNCCH::ReadNCCHData(*this);
+    });
+
     result = LoadExec(process); // Load the executable into memory for booting
+    boot_workers.Wait();
     if (ResultStatus::Success != result)
         return result;
 
-    system.ArchiveManager().RegisterSelfNCCH(*this);
+    system.ArchiveManager().RegisterSelfNCCH(ncch_program_id, std::move(self_ncch_data));
 
     ParseRegionLockoutInfo(ncch_program_id);
 
@@ -2,8 +2,15 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <cstring>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/binary_object.hpp>
 #include "audio_core/dsp_interface.h"
@@ -14,6 +21,7 @@
 #include "common/logging/log.h"
 #include "common/settings.h"
 #include "common/swap.h"
+#include "common/virtual_buffer.h"
 #include "core/arm/arm_interface.h"
 #include "core/core.h"
 #include "core/global.h"
@@ -21,6 +29,7 @@
 #include "core/hle/service/plgldr/plgldr.h"
 #include "core/memory.h"
 #include "video_core/gpu.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/renderer_base.h"
 
 SERIALIZE_EXPORT_IMPL(Memory::MemorySystem::BackingMemImpl<Memory::Region::FCRAM>)
@@ -84,19 +93,161 @@ private:
     }
 };
 
+/**
+ * Records CPU writes to rasterizer cached pages, so the rasterizer cache is invalidated once per
+ * written range instead of once per store. Consecutive writes are coalesced into runs of exact
+ * byte ranges, invalidating whole pages could drop GPU data that was not flushed yet. A bitmap of
+ * the pages with pending writes lets reads of unrelated memory skip the queue.
+ */
+class RasterizerWriteTracker {
+public:
+    using Run = std::pair<VAddr, VAddr>;
+
+    /// Records a write of size bytes at addr. Returns true when the queue should be committed.
+    bool Record(VAddr addr, u32 size) {
+        const VAddr end = addr + size;
+        MarkPages(addr, end, true);
+        if (HasPending() && addr <= run_end && end >= run_start) {
+            run_start = std::min(run_start, addr);
+            run_end = std::max(run_end, end);
+            return false;
+        }
+        if (HasPending()) {
+            runs.emplace_back(run_start, run_end);
+        }
+        run_start = addr;
+        run_end = end;
+        return runs.size() >= MaxRuns;
+    }
+
+    bool HasPending() const {
+        return run_start != run_end;
+    }
+
+    /// Returns true if any page in the range has pending writes.
+    bool IsPending(VAddr addr, u32 size) const {
+        if (!HasPending()) {
+            return false;
+        }
+        for (VAddr page = addr & ~CYTRUS_PAGE_MASK; page < addr + size; page += CYTRUS_PAGE_SIZE) {
+            const std::size_t index = PageIndex(page);
+            if (index != InvalidPage && (bitmap[index / 64] >> (index % 64)) & 1) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Calls func with the start and end of every pending run.
+    template <typename Func>
+    void ForEachRun(Func&& func) const {
+        for (const auto& [start, end] : runs) {
+            func(start, end);
+        }
+        if (HasPending()) {
+            func(run_start, run_end);
+        }
+    }
+
+    /// Moves the pending runs to out and clears the queue.
+    void Drain(std::vector<Run>& out) {
+        if (HasPending()) {
+            runs.emplace_back(run_start, run_end);
+        }
+        for (const auto& [start, end] : runs) {
+            MarkPages(start, end, false);
+        }
+        run_start = run_end = 0;
+        out.swap(runs);
+        runs.clear();
+    }
+
+private:
+    static constexpr std::size_t MaxRuns = 256;
+    static constexpr std::size_t InvalidPage = std::numeric_limits<std::size_t>::max();
+
+    static constexpr std::size_t VramPages = VRAM_SIZE / CYTRUS_PAGE_SIZE;
+    static constexpr std::size_t LinearHeapPages = LINEAR_HEAP_SIZE / CYTRUS_PAGE_SIZE;
+    static constexpr std::size_t NewLinearHeapPages = NEW_LINEAR_HEAP_SIZE / CYTRUS_PAGE_SIZE;
+    static constexpr std::size_t PluginFbPages =
+        (PLUGIN_3GX_FB_SIZE + CYTRUS_PAGE_SIZE - 1) / CYTRUS_PAGE_SIZE;
+    static constexpr std::size_t NumPages =
+        VramPages + LinearHeapPages + NewLinearHeapPages + PluginFbPages;
+
+    /// Returns the bitmap index of the page at addr, the pages of the cacheable regions are
+    /// laid out back to back.
+    static std::size_t PageIndex(VAddr addr) {
+        if (addr >= VRAM_VADDR && addr < VRAM_VADDR_END) {
+            return (addr - VRAM_VADDR) / CYTRUS_PAGE_SIZE;
+        }
+        if (addr >= LINEAR_HEAP_VADDR && addr < LINEAR_HEAP_VADDR_END) {
+            return VramPages + (addr - LINEAR_HEAP_VADDR) / CYTRUS_PAGE_SIZE;
+        }
+        if (addr >= NEW_LINEAR_HEAP_VADDR && addr < NEW_LINEAR_HEAP_VADDR_END) {
+            return VramPages + LinearHeapPages + (addr - NEW_LINEAR_HEAP_VADDR) / CYTRUS_PAGE_SIZE;
+        }
+        if (addr >= PLUGIN_3GX_FB_VADDR && addr < PLUGIN_3GX_FB_VADDR_END) {
+            return VramPages + LinearHeapPages + NewLinearHeapPages +
+                   (addr - PLUGIN_3GX_FB_VADDR) / CYTRUS_PAGE_SIZE;
+        }
+        return InvalidPage;
+    }
+
+    void MarkPages(VAddr start, VAddr end, bool pending) {
+        for (VAddr page = start & ~CYTRUS_PAGE_MASK; page < end; page += CYTRUS_PAGE_SIZE) {
+            const std::size_t index = PageIndex(page);
+            if (index == InvalidPage) {
+                continue;
+            }
+            const u64 bit = u64{1} << (index % 64);
+            if (pending) {
+                bitmap[index / 64] |= bit;
+            } else {
+                bitmap[index / 64] &= ~bit;
+            }
+        }
+    }
+
+    std::vector<u64> bitmap = std::vector<u64>((NumPages + 63) / 64);
+    std::vector<Run> runs;
+    VAddr run_start{};
+    VAddr run_end{};
+};
+
 class MemorySystem::Impl {
 public:
-    // Visual Studio would try to allocate these on compile time
-    // if they are std::array which would exceed the memory limit.
-    std::unique_ptr<u8[]> fcram = std::make_unique<u8[]>(Memory::FCRAM_N3DS_SIZE);
-    std::unique_ptr<u8[]> vram = std::make_unique<u8[]>(Memory::VRAM_SIZE);
-    std::unique_ptr<u8[]> n3ds_extra_ram = std::make_unique<u8[]>(Memory::N3DS_EXTRA_RAM_SIZE);
+    // Backed by lazily committed host pages, so only the memory touched by the guest is resident.
+    // Old 3DS titles never touch the upper half of FCRAM.
+    Common::VirtualBuffer<u8> fcram{Memory::FCRAM_N3DS_SIZE};
+    Common::VirtualBuffer<u8> vram{Memory::VRAM_SIZE};
+    Common::VirtualBuffer<u8> n3ds_extra_ram{Memory::N3DS_EXTRA_RAM_SIZE};
 
     Core::System& system;
     std::shared_ptr<PageTable> current_page_table = nullptr;
     RasterizerCacheMarker cache_marker;
+    RasterizerWriteTracker write_tracker;
+    std::vector<RasterizerWriteTracker::Run> committed_writes;
     std::vector<std::shared_ptr<PageTable>> page_table_list;
 
+    // Orders the CPU writes to cached pages against the flushes of the GPU thread. Writes to the
+    // range being flushed wait for it, pending writes inside it are restored after it.
+    std::mutex write_mutex;
+    std::condition_variable flush_cv;
+    PAddr flush_start{};
+    PAddr flush_end{};
+    std::vector<std::pair<PAddr, u32>> flush_backup_ranges;
+    std::vector<u8> flush_backup;
+
+    // Cache marks made on the GPU thread, applied to the page tables on the emulation thread.
+    struct CacheMark {
+        PAddr start;
+        u32 size;
+        bool cached;
+    };
+    std::mutex cache_mark_mutex;
+    std::vector<CacheMark> pending_cache_marks;
+    std::atomic<bool> has_pending_cache_marks{};
+
     AudioCore::DspInterface* dsp = nullptr;
 
     std::shared_ptr<BackingMem> fcram_mem;
@@ -109,13 +260,13 @@ public:
     const u8* GetPtr(Region r) const {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram.data();
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram.data();
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram.data();
         default:
             UNREACHABLE();
         }
@@ -124,13 +275,13 @@ public:
     u8* GetPtr(Region r) {
         switch (r) {
         case Region::VRAM:
-            return vram.get();
+            return vram.data();
         case Region::DSP:
             return dsp->GetDspMemory().data();
         case Region::FCRAM:
-            return fcram.get();
+            return fcram.data();
         case Region::N3DS:
-            return n3ds_extra_ram.get();
+            return n3ds_extra_ram.data();
         default:
             UNREACHABLE();
         }
@@ -237,11 +388,15 @@ public:
                 break;
             }
             case PageType::RasterizerCachedMemory: {
+                const auto store = [&] {
+                    std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer,
+                                copy_amount);
+                };
                 if constexpr (!UNSAFE) {
-                    RasterizerFlushVirtualRegion(current_vaddr, static_cast<u32>(copy_amount),
-                                                 FlushMode::Invalidate);
+                    RecordRasterizerWrite(current_vaddr, static_cast<u32>(copy_amount), store);
+                } else {
+                    store();
                 }
-                std::memcpy(GetPointerForRasterizerCache(current_vaddr), src_buffer, copy_amount);
                 break;
             }
             default:
@@ -277,22 +432,83 @@ public:
         return MemoryRef{};
     }
 
-    void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
-        const VAddr end = start + size;
-
+    /// Calls func with the physical address and size of each part of [start, end) that lies in a
+    /// region the rasterizer caches.
+    template <typename Func>
+    void ForEachRasterizerRegion(VAddr start, VAddr end, Func&& func) {
         auto CheckRegion = [&](VAddr region_start, VAddr region_end, PAddr paddr_region_start) {
             if (start >= region_end || end <= region_start) {
                 // No overlap with region
                 return;
             }
+            const VAddr overlap_start = std::max(start, region_start);
+            const VAddr overlap_end = std::min(end, region_end);
+            func(paddr_region_start + (overlap_start - region_start),
+                 static_cast<u32>(overlap_end - overlap_start));
+        };
+
+        CheckRegion(LINEAR_HEAP_VADDR, LINEAR_HEAP_VADDR_END, FCRAM_PADDR);
+        CheckRegion(NEW_LINEAR_HEAP_VADDR, NEW_LINEAR_HEAP_VADDR_END, FCRAM_PADDR);
+        CheckRegion(VRAM_VADDR, VRAM_VADDR_END, VRAM_PADDR);
+        auto plg_ldr = Service::PLGLDR::GetService(system);
+        if (plg_ldr && plg_ldr->GetPluginFBAddr()) {
+            CheckRegion(PLUGIN_3GX_FB_VADDR, PLUGIN_3GX_FB_VADDR_END, plg_ldr->GetPluginFBAddr());
+        }
+    }
+
+    /// Returns true if the GPU thread is flushing a range that overlaps the write.
+    bool IsFlushing(VAddr addr, u32 size) {
+        if (flush_start == flush_end) {
+            return false;
+        }
+        bool overlaps = false;
+        ForEachRasterizerRegion(addr, addr + size, [&](PAddr paddr, u32 part_size) {
+            overlaps |= paddr < flush_end && paddr + part_size > flush_start;
+        });
+        return overlaps;
+    }
 
-            auto& renderer = system.GPU().Renderer();
-            VAddr overlap_start = std::max(start, region_start);
-            VAddr overlap_end = std::min(end, region_end);
-            PAddr physical_start = paddr_region_start + (overlap_start - region_start);
-            u32 overlap_size = overlap_end - overlap_start;
+    /// Records a write to a rasterizer cached page and performs it with store.
+    template <typename Func>
+    void RecordRasterizerWrite(VAddr addr, u32 size, Func&& store) {
+        bool commit;
+        {
+            std::unique_lock lock{write_mutex};
+            flush_cv.wait(lock, [&] { return !IsFlushing(addr, size); });
+            commit = write_tracker.Record(addr, size);
+            store();
+        }
+        if (commit) {
+            CommitRasterizerWrites();
+        }
+    }
 
-            auto* rasterizer = renderer.Rasterizer();
+    void CommitRasterizerWrites() {
+        if (!write_tracker.HasPending()) {
+            return;
+        }
+        {
+            std::scoped_lock lock{write_mutex};
+            write_tracker.Drain(committed_writes);
+        }
+        for (const auto& [start, end] : committed_writes) {
+            RasterizerFlushVirtualRegion(start, end - start, FlushMode::Invalidate);
+        }
+        committed_writes.clear();
+    }
+
+    void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
+        // Pending CPU writes must invalidate the cache before a flush can overwrite them.
+        if (mode != FlushMode::Invalidate && write_tracker.IsPending(start, size)) {
+            CommitRasterizerWrites();
+        }
+
+        ForEachRasterizerRegion(start, start + size, [&](PAddr physical_start, u32 overlap_size) {
+            // The GPU thread owns the rasterizer while it has work queued.
+            auto& gpu = system.GPU();
+            gpu.WaitIdle();
+
+            auto* rasterizer = gpu.Renderer().Rasterizer();
             switch (mode) {
             case FlushMode::Flush:
                 rasterizer->FlushRegion(physical_start, overlap_size);
@@ -304,15 +520,7 @@ public:
                 rasterizer->FlushAndInvalidateRegion(physical_start, overlap_size);
                 break;
             }
-        };
-
-        CheckRegion(LINEAR_HEAP_VADDR, LINEAR_HEAP_VADDR_END, FCRAM_PADDR);
-        CheckRegion(NEW_LINEAR_HEAP_VADDR, NEW_LINEAR_HEAP_VADDR_END, FCRAM_PADDR);
-        CheckRegion(VRAM_VADDR, VRAM_VADDR_END, VRAM_PADDR);
-        auto plg_ldr = Service::PLGLDR::GetService(system);
-        if (plg_ldr && plg_ldr->GetPluginFBAddr()) {
-            CheckRegion(PLUGIN_3GX_FB_VADDR, PLUGIN_3GX_FB_VADDR_END, plg_ldr->GetPluginFBAddr());
-        }
+        });
     }
 
 private:
@@ -321,12 +529,20 @@ private:
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds.GetValue();
         ar & save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
+        ar& boost::serialization::make_binary_object(vram.data(), Memory::VRAM_SIZE);
         ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+            fcram.data(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
         ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+            n3ds_extra_ram.data(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
         ar & cache_marker;
+        if (Archive::is_loading::value) {
+            // The rasterizer cache is rebuilt after loading, the pending writes are stale.
+            std::scoped_lock lock{write_mutex, cache_mark_mutex};
+            write_tracker.Drain(committed_writes);
+            committed_writes.clear();
+            pending_cache_marks.clear();
+            has_pending_cache_marks = false;
+        }
         ar & page_table_list;
         // dsp is set from Core::System at startup
         ar & current_page_table;
@@ -392,6 +608,69 @@ void MemorySystem::RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode
     impl->RasterizerFlushVirtualRegion(start, size, mode);
 }
 
+void MemorySystem::RasterizerCommitWrites() {
+    impl->CommitRasterizerWrites();
+}
+
+void MemorySystem::RasterizerBeginFlush(PAddr start, u32 size) {
+    // The emulation thread commits its pending writes before flushing.
+    if (!VideoCore::GPUThread::IsGPUThread()) {
+        return;
+    }
+
+    std::scoped_lock lock{impl->write_mutex};
+    impl->flush_start = start;
+    impl->flush_end = start + size;
+    impl->write_tracker.ForEachRun([&](VAddr run_start, VAddr run_end) {
+        impl->ForEachRasterizerRegion(run_start, run_end, [&](PAddr paddr, u32 part_size) {
+            const PAddr backup_start = std::max(paddr, impl->flush_start);
+            const PAddr backup_end = std::min(paddr + part_size, impl->flush_end);
+            if (backup_start >= backup_end) {
+                return;
+            }
+            const u8* data = GetPhysicalPointer(backup_start);
+            impl->flush_backup_ranges.emplace_back(backup_start, backup_end - backup_start);
+            impl->flush_backup.insert(impl->flush_backup.end(), data,
+                                      data + (backup_end - backup_start));
+        });
+    });
+}
+
+void MemorySystem::RasterizerEndFlush() {
+    if (!VideoCore::GPUThread::IsGPUThread()) {
+        return;
+    }
+
+    {
+        std::scoped_lock lock{impl->write_mutex};
+        // The pending writes are newer than the flushed data, they invalidate it once committed.
+        const u8* data = impl->flush_backup.data();
+        for (const auto& [paddr, size] : impl->flush_backup_ranges) {
+            std::memcpy(GetPhysicalPointer(paddr), data, size);
+            data += size;
+        }
+        impl->flush_backup_ranges.clear();
+        impl->flush_backup.clear();
+        impl->flush_start = impl->flush_end = 0;
+    }
+    impl->flush_cv.notify_all();
+}
+
+void MemorySystem::RasterizerApplyCacheMarks() {
+    if (!impl->has_pending_cache_marks.load(std::memory_order_acquire)) {
+        return;
+    }
+    std::vector<Impl::CacheMark> marks;
+    {
+        std::scoped_lock lock{impl->cache_mark_mutex};
+        marks.swap(impl->pending_cache_marks);
+        impl->has_pending_cache_marks = false;
+    }
+    for (const auto& mark : marks) {
+        MarkRegionCached(mark.start, mark.size, mark.cached);
+    }
+}
+
 void MemorySystem::MapPages(PageTable& page_table, u32 base, u32 size, MemoryRef memory,
                             PageType type) {
     LOG_DEBUG(HW_Memory, "Mapping {} onto {:08X}-{:08X}", (void*)memory.GetPtr(),
@@ -534,8 +813,9 @@ void MemorySystem::Write(const VAddr vaddr, const T data) {
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
         break;
     case PageType::RasterizerCachedMemory: {
-        RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
-        std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
+        impl->RecordRasterizerWrite(vaddr, sizeof(T), [&] {
+            std::memcpy(GetPointerForRasterizerCache(vaddr), &data, sizeof(T));
+        });
         break;
     }
     default:
@@ -563,10 +843,13 @@ bool MemorySystem::WriteExclusive(const VAddr vaddr, const T data, const T expec
         ASSERT_MSG(false, "Mapped memory page without a pointer @ {:08X}", vaddr);
         return true;
     case PageType::RasterizerCachedMemory: {
-        RasterizerFlushVirtualRegion(vaddr, sizeof(T), FlushMode::Invalidate);
-        const auto volatile_pointer =
-            reinterpret_cast<volatile T*>(GetPointerForRasterizerCache(vaddr).GetPtr());
-        return Common::AtomicCompareAndSwap(volatile_pointer, data, expected);
+        bool result{};
+        impl->RecordRasterizerWrite(vaddr, sizeof(T), [&] {
+            const auto volatile_pointer =
+                reinterpret_cast<volatile T*>(GetPointerForRasterizerCache(vaddr).GetPtr());
+            result = Common::AtomicCompareAndSwap(volatile_pointer, data, expected);
+        });
+        return result;
     }
     default:
         UNREACHABLE();
@@ -723,6 +1006,20 @@ void MemorySystem::RasterizerMarkRegionCached(PAddr start, u32 size, bool cached
         return;
     }
 
+    // The page tables belong to the emulation thread, which may be running guest code.
+    if (VideoCore::GPUThread::IsGPUThread()) {
+        std::scoped_lock lock{impl->cache_mark_mutex};
+        impl->pending_cache_marks.push_back({start, size, cached});
+        impl->has_pending_cache_marks.store(true, std::memory_order_release);
+        return;
+    }
+
+    // Keep the order of the marks made on the GPU thread before this one.
+    RasterizerApplyCacheMarks();
+    MarkRegionCached(start, size, cached);
+}
+
+void MemorySystem::MarkRegionCached(PAddr start, u32 size, bool cached) {
     u32 num_pages = ((start + size - 1) >> CYTRUS_PAGE_BITS) - (start >> CYTRUS_PAGE_BITS) + 1;
     PAddr paddr = start;
 
@@ -933,18 +1230,31 @@ void MemorySystem::CopyBlock(const Kernel::Process& dest_process,
 }
 
 u32 MemorySystem::GetFCRAMOffset(const u8* pointer) const {
-    ASSERT(pointer >= impl->fcram.get() && pointer <= impl->fcram.get() + Memory::FCRAM_N3DS_SIZE);
-    return static_cast<u32>(pointer - impl->fcram.get());
+    ASSERT(pointer >= impl->fcram.data() && pointer <= impl->fcram.data() + Memory::FCRAM_N3DS_SIZE);
+    return static_cast<u32>(pointer - impl->fcram.data());
 }
 
 u8* MemorySystem::GetFCRAMPointer(std::size_t offset) {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram.data() + offset;
 }
 
 const u8* MemorySystem::GetFCRAMPointer(std::size_t offset) const {
     ASSERT(offset <= Memory::FCRAM_N3DS_SIZE);
-    return impl->fcram.get() + offset;
+    return impl->fcram.data() + offset;
+}
+
+void MemorySystem::ClearFCRAM(std::size_t offset, std::size_t size) {
+    ASSERT(offset + size <= Memory::FCRAM_N3DS_SIZE);
+    impl->fcram.Decommit(offset, size);
+}
+
+MemoryFootprint MemorySystem::GetFootprint() const {
+    return MemoryFootprint{
+        .fcram = impl->fcram.ResidentSize(),
+        .vram = impl->vram.ResidentSize(),
+        .n3ds_extra_ram = impl->n3ds_extra_ram.ResidentSize(),
+    };
 }
 
 MemoryRef MemorySystem::GetFCRAMRef(std::size_t offset) const {
@@ -105,6 +105,9 @@ private:
 // Overloaded GetSize, accepts FILE*
 [[nodiscard]] u64 GetSize(FILE* f);
 
+// Returns the last modification time of filename in seconds, or 0 if it is unknown
+[[nodiscard]] s64 GetModificationTime(const std::string& filename);
+
 // Returns true if successful, or path already exists.
 bool CreateDir(const std::string& filename);
 
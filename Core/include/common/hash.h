@@ -8,6 +8,7 @@
 #include <cstring>
 #include "common/cityhash.h"
 #include "common/common_types.h"
+#include "common/xxh3.h"
 
 namespace Common {
 
@@ -18,6 +19,18 @@ namespace Common {
  * @returns 64-bit hash value that was computed over the data block
  */
 static inline u64 ComputeHash64(const void* data, std::size_t len) noexcept {
+    return XXH3Hash64(data, len);
+}
+
+/**
+ * Computes the CityHash64 of the specified block of data. Only use this for hashes that are
+ * stored outside of the emulator, such as the texture hashes of custom texture packs, that must
+ * stay stable across versions.
+ * @param data Block of data to compute hash over
+ * @param len Length of data (in bytes) to compute hash over
+ * @returns 64-bit hash value that was computed over the data block
+ */
+static inline u64 ComputeLegacyHash64(const void* data, std::size_t len) noexcept {
     return CityHash64(static_cast<const char*>(data), len);
 }
 
@@ -6,9 +6,14 @@
 
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 #include "common/logging/formatter.h"
+#include "common/logging/log_entry.h"
 #include "common/logging/types.h"
 
 namespace Common::Log {
@@ -27,11 +32,51 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, fmt::string_view format,
                        const fmt::format_args& args);
 
+/// Logs a message to the global logger, formatting it later on the logging thread
+void DeferredLogMessageImpl(Class log_class, Level log_level, const char* filename,
+                            unsigned int line_num, const char* function, fmt::string_view format,
+                            DeferredFormatter formatter,
+                            const std::array<u8, MaxDeferredArgsSize>& args);
+
+/**
+ * Arguments can be captured by value for deferred formatting when they do not refer to memory
+ * owned by the caller, which only holds for plain numbers and enumerations.
+ */
+template <typename... Args>
+constexpr bool CanDeferFormat =
+    ((std::is_arithmetic_v<Args> || std::is_enum_v<Args>) && ...) &&
+    (sizeof(Args) + ... + 0) <= MaxDeferredArgsSize;
+
+template <typename... Args>
+std::string FormatDeferredArgs(std::string_view format, const u8* data) {
+    std::tuple<Args...> args{};
+    [[maybe_unused]] std::size_t offset = 0;
+    std::apply(
+        [data, &offset](auto&... arg) {
+            ((std::memcpy(&arg, data + offset, sizeof(arg)), offset += sizeof(arg)), ...);
+        },
+        args);
+    return std::apply(
+        [format](const auto&... arg) {
+            return fmt::vformat(fmt::string_view{format.data(), format.size()},
+                                fmt::make_format_args(arg...));
+        },
+        args);
+}
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, fmt::format_string<Args...> format, const Args&... args) {
-    FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
-                      fmt::make_format_args(args...));
+    if constexpr (CanDeferFormat<Args...>) {
+        std::array<u8, MaxDeferredArgsSize> data;
+        [[maybe_unused]] std::size_t offset = 0;
+        ((std::memcpy(data.data() + offset, &args, sizeof(Args)), offset += sizeof(Args)), ...);
+        DeferredLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                               &FormatDeferredArgs<Args...>, data);
+    } else {
+        FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                          fmt::make_format_args(args...));
+    }
 }
 
 } // namespace Common::Log
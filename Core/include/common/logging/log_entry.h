@@ -4,12 +4,21 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <string>
+#include <string_view>
 
 #include "common/logging/types.h"
 
 namespace Common::Log {
 
+/// Maximum size in bytes of the arguments captured by a message with deferred formatting.
+constexpr std::size_t MaxDeferredArgsSize = 48;
+
+/// Formats the arguments captured in `args` with `format`.
+using DeferredFormatter = std::string (*)(std::string_view format, const u8* args);
+
 /**
  * A log entry. Log entries are store in a structured format to permit more varied output
  * formatting on different frontends, as well as facilitating filtering and aggregation.
@@ -20,8 +29,13 @@ struct Entry {
     Level log_level{};
     const char* filename = nullptr;
     u32 line_num = 0;
-    std::string function;
+    const char* function = nullptr;
     std::string message;
+
+    /// When set, `message` is produced by the logging thread from `format` and `deferred_args`.
+    DeferredFormatter deferred_formatter = nullptr;
+    std::string_view format;
+    std::array<u8, MaxDeferredArgsSize> deferred_args;
 };
 
 } // namespace Common::Log
@@ -25,4 +25,10 @@ struct MemoryInfo {
  */
 u64 GetPageSize();
 
+/**
+ * Gets the resident set size of the current process
+ * @return Resident memory in bytes, or 0 when the host cannot report it
+ */
+u64 GetProcessResidentMemory();
+
 } // namespace Common
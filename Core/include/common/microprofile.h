@@ -21,5 +21,14 @@ typedef void* HANDLE;
 #endif
 
 #include <microprofile.h>
+#include "common/tracing.h"
 
 #define MP_RGB(r, g, b) ((r) << 16 | (g) << 8 | (b) << 0)
+
+// Scopes are also recorded by the timeline tracing when a tracing session is active.
+#if MICROPROFILE_ENABLED
+#undef MICROPROFILE_SCOPE
+#define MICROPROFILE_SCOPE(var)                                                                    \
+    MicroProfileScopeHandler MICROPROFILE_TOKEN_PASTE(foo, __LINE__)(g_mp_##var);                 \
+    Common::Tracing::TokenScope MICROPROFILE_TOKEN_PASTE(trace, __LINE__)(g_mp_##var)
+#endif
@@ -0,0 +1,149 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/polyfill_thread.h"
+#include "common/unique_function.h"
+#include "common/work_stealing_deque.h"
+
+namespace Common {
+
+class TaskGroup;
+
+enum class TaskPriority : u32 {
+    High,
+    Normal,
+    Low,
+    Count,
+};
+
+/**
+ * Process-wide pool of worker threads shared by every subsystem. Each worker owns a work stealing
+ * deque that receives the tasks spawned from that worker. Tasks submitted from other threads go
+ * through a queue per priority. Idle workers take high priority tasks first, then steal from the
+ * other workers, then take normal and low priority tasks.
+ */
+class TaskScheduler {
+public:
+    struct Task {
+        UniqueFunction<void> func;
+        TaskGroup* group;
+        TaskPriority priority;
+    };
+
+    explicit TaskScheduler(std::size_t num_workers);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    /// Returns the scheduler shared by the whole process.
+    static TaskScheduler& Instance();
+
+    /// Queues a task for execution on any worker.
+    void Schedule(std::unique_ptr<Task> task);
+
+    /// Runs one queued task on the calling thread. Returns false if no task was found.
+    bool TryRunOne();
+
+    /// Returns true if the calling thread is one of the workers of this scheduler.
+    bool IsWorkerThread() const;
+
+    std::size_t NumWorkers() const noexcept {
+        return workers.size();
+    }
+
+private:
+    struct Worker {
+        WorkStealingDeque<Task*> deque;
+        std::jthread thread;
+    };
+
+    void WorkerLoop(std::stop_token stop_token, std::size_t index);
+    Task* FindTask(std::size_t index);
+    Task* PopInjected(TaskPriority priority);
+    Task* StealFrom(std::size_t first);
+    void Execute(Task* task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::array<std::deque<Task*>, static_cast<std::size_t>(TaskPriority::Count)> injected;
+    std::mutex injected_mutex;
+
+    std::atomic<std::size_t> num_queued{};
+    std::atomic<std::size_t> num_sleeping{};
+    std::mutex sleep_mutex;
+    std::condition_variable_any sleep_cv;
+};
+
+/**
+ * A set of related tasks submitted by one subsystem. The group limits how many of its tasks run
+ * at the same time, so a single subsystem can not take over the whole scheduler, and allows
+ * waiting for all of its tasks. Destroying the group drops the tasks that have not started yet and
+ * waits for the running ones.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(std::string_view name, std::size_t max_concurrency,
+                       TaskPriority priority = TaskPriority::Normal,
+                       TaskScheduler& scheduler = TaskScheduler::Instance());
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// Queues a task with the priority of the group.
+    void QueueWork(UniqueFunction<void> func);
+
+    /// Queues a task with an explicit priority.
+    void QueueWork(UniqueFunction<void> func, TaskPriority task_priority);
+
+    /// Blocks until every queued task of the group has finished.
+    void Wait();
+
+    /// Blocks until every queued task of the group has finished or the timeout expires.
+    /// Returns true if the group is idle.
+    bool WaitFor(std::chrono::milliseconds timeout);
+
+    /// Returns the maximum number of tasks of the group that may run at the same time.
+    std::size_t MaxConcurrency() const noexcept {
+        return max_concurrency;
+    }
+
+    const std::string& Name() const noexcept {
+        return name;
+    }
+
+private:
+    friend class TaskScheduler;
+
+    /// Called by the scheduler after a task of this group has run or was skipped.
+    void OnTaskFinished();
+
+    TaskScheduler& scheduler;
+    std::string name;
+    std::size_t max_concurrency;
+    TaskPriority priority;
+
+    std::mutex mutex;
+    std::condition_variable idle_cv;
+    std::deque<std::unique_ptr<TaskScheduler::Task>> pending;
+    std::size_t running{};
+    std::size_t outstanding{};
+    std::atomic_bool cancelled{false};
+};
+
+} // namespace Common
@@ -0,0 +1,94 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include "common/common_types.h"
+
+/**
+ * Timeline tracing of the profiling scopes. While a session is recording every thread appends
+ * begin and end events to its own buffer without taking locks. Stopping the session writes the
+ * events of all threads as a Chrome trace event JSON file, which can be opened with
+ * chrome://tracing or the Perfetto UI. When no session is recording a scope costs a single relaxed
+ * load.
+ */
+namespace Common::Tracing {
+
+namespace Detail {
+extern std::atomic_bool enabled;
+} // namespace Detail
+
+/// Returns true while a tracing session is recording.
+[[nodiscard]] inline bool IsEnabled() noexcept {
+    return Detail::enabled.load(std::memory_order_relaxed);
+}
+
+/// Starts a tracing session, dropping the events of the previous one.
+void Start();
+
+/// Stops the tracing session and writes the recorded events to path. Returns false if no session
+/// was recording or the file could not be written.
+bool Stop(const std::string& path);
+
+/// Returns a copy of name that lives as long as the process, for event names owned by objects
+/// that can be destroyed while a session is recording.
+const char* InternName(std::string_view name);
+
+/// Records the start of a scope on the calling thread. Both strings must outlive the session.
+void BeginEvent(const char* category, const char* name) noexcept;
+
+/// Records the start of a microprofile scope on the calling thread.
+void BeginEvent(u64 microprofile_token) noexcept;
+
+/// Records the end of the innermost open scope of the calling thread.
+void EndEvent() noexcept;
+
+/// Records a scope with a static name for its lifetime.
+class Scope {
+public:
+    explicit Scope(const char* category, const char* name) noexcept : active{IsEnabled()} {
+        if (active) [[unlikely]] {
+            BeginEvent(category, name);
+        }
+    }
+
+    ~Scope() {
+        if (active) [[unlikely]] {
+            EndEvent();
+        }
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active;
+};
+
+/// Records a microprofile scope for its lifetime, see MICROPROFILE_SCOPE.
+class TokenScope {
+public:
+    explicit TokenScope(u64 token) noexcept : active{IsEnabled()} {
+        if (active) [[unlikely]] {
+            BeginEvent(token);
+        }
+    }
+
+    ~TokenScope() {
+        if (active) [[unlikely]] {
+            EndEvent();
+        }
+    }
+
+    TokenScope(const TokenScope&) = delete;
+    TokenScope& operator=(const TokenScope&) = delete;
+
+private:
+    bool active;
+};
+
+} // namespace Common::Tracing
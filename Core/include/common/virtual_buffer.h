@@ -0,0 +1,101 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace Common {
+
+/**
+ * Reserves size bytes of zeroed host memory. POSIX hosts commit the pages on first touch. Windows
+ * commits the whole range up front, which is charged against the commit limit even though the
+ * physical pages are only assigned on first touch.
+ */
+void* AllocateMemoryPages(std::size_t size) noexcept;
+
+/// Releases memory returned by AllocateMemoryPages.
+void FreeMemoryPages(void* base, std::size_t size) noexcept;
+
+/**
+ * Returns the host memory backing the range to the system while keeping it reserved. The range
+ * reads as zero afterwards. Only the host pages fully inside the range are released, the partial
+ * pages at either end are cleared instead.
+ */
+void DecommitMemoryPages(void* base, std::size_t size) noexcept;
+
+/// Returns the number of bytes of the range that are resident in host memory, or 0 when the host
+/// cannot report it.
+std::size_t GetResidentMemory(const void* base, std::size_t size) noexcept;
+
+/// Zero initialized buffer of trivial objects backed by host pages committed as described in
+/// AllocateMemoryPages.
+template <typename T>
+class VirtualBuffer final {
+    static_assert(std::is_trivially_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                  "T must be a trivial type");
+
+public:
+    constexpr VirtualBuffer() = default;
+
+    explicit VirtualBuffer(std::size_t count) : alloc_size{count * sizeof(T)} {
+        base_ptr = static_cast<T*>(AllocateMemoryPages(alloc_size));
+    }
+
+    ~VirtualBuffer() noexcept {
+        FreeMemoryPages(base_ptr, alloc_size);
+    }
+
+    VirtualBuffer(const VirtualBuffer&) = delete;
+    VirtualBuffer& operator=(const VirtualBuffer&) = delete;
+
+    VirtualBuffer(VirtualBuffer&& other) noexcept
+        : alloc_size{std::exchange(other.alloc_size, 0)},
+          base_ptr{std::exchange(other.base_ptr, nullptr)} {}
+
+    VirtualBuffer& operator=(VirtualBuffer&& other) noexcept {
+        FreeMemoryPages(base_ptr, alloc_size);
+        alloc_size = std::exchange(other.alloc_size, 0);
+        base_ptr = std::exchange(other.base_ptr, nullptr);
+        return *this;
+    }
+
+    [[nodiscard]] T& operator[](std::size_t index) {
+        return base_ptr[index];
+    }
+
+    [[nodiscard]] const T& operator[](std::size_t index) const {
+        return base_ptr[index];
+    }
+
+    [[nodiscard]] T* data() noexcept {
+        return base_ptr;
+    }
+
+    [[nodiscard]] const T* data() const noexcept {
+        return base_ptr;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return alloc_size / sizeof(T);
+    }
+
+    /// Releases the host memory of the elements in [offset, offset + count), they read as zero.
+    void Decommit(std::size_t offset, std::size_t count) noexcept {
+        DecommitMemoryPages(base_ptr + offset, count * sizeof(T));
+    }
+
+    /// Returns the number of bytes of the buffer resident in host memory.
+    [[nodiscard]] std::size_t ResidentSize() const noexcept {
+        return GetResidentMemory(base_ptr, alloc_size);
+    }
+
+private:
+    std::size_t alloc_size{};
+    T* base_ptr{};
+};
+
+} // namespace Common
@@ -0,0 +1,93 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Bounded Chase-Lev work stealing deque, following "Correct and Efficient Work-Stealing for Weak
+ * Memory Models" (Le et al. 2013). The owning thread pushes and pops at the bottom, any other
+ * thread may steal from the top. Items must be pointers, nullptr signals an empty deque.
+ */
+template <typename T, std::size_t Capacity = 1024>
+class WorkStealingDeque {
+    static_assert(std::is_pointer_v<T>, "WorkStealingDeque only stores pointers.");
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+
+public:
+    /// Pushes an item at the bottom. Owner only. Returns false if the deque is full.
+    bool Push(T item) {
+        const s64 b = bottom.load(std::memory_order_relaxed);
+        const s64 t = top.load(std::memory_order_acquire);
+        if (b - t >= static_cast<s64>(Capacity)) {
+            return false;
+        }
+        buffer[b & Mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Pops the most recently pushed item. Owner only.
+    T Pop() {
+        const s64 b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        s64 t = top.load(std::memory_order_relaxed);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T item = buffer[b & Mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last item, race against the thieves for it.
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// Steals the least recently pushed item. Safe to call from any thread.
+    T Steal() {
+        s64 t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const s64 b = bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        T item = buffer[t & Mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+    /// Returns an approximation of the number of items in the deque.
+    std::size_t Size() const {
+        const s64 b = bottom.load(std::memory_order_relaxed);
+        const s64 t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<std::size_t>(b - t) : 0;
+    }
+
+private:
+    static constexpr s64 Mask = static_cast<s64>(Capacity) - 1;
+
+    alignas(128) std::atomic<s64> top{0};
+    alignas(128) std::atomic<s64> bottom{0};
+    alignas(128) std::array<std::atomic<T>, Capacity> buffer{};
+};
+
+} // namespace Common
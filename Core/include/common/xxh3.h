@@ -0,0 +1,20 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <cstddef>
+#include "common/common_types.h"
+
+namespace Common {
+
+/**
+ * Computes the 64-bit XXH3 hash of a block of data, with the default secret and a zero seed.
+ * The output matches the reference XXH3_64bits implementation. Inputs larger than 240 bytes are
+ * processed with the widest vector unit available on the host (AVX2 or SSE2 on x86-64, NEON on
+ * arm64), selected at runtime.
+ */
+[[nodiscard]] u64 XXH3Hash64(const void* data, std::size_t len) noexcept;
+
+} // namespace Common
@@ -4,8 +4,8 @@
 
 #pragma once
 
-#include <map>
 #include <memory>
+#include <vector>
 #include <dynarmic/interface/A32/a32.h>
 #include "common/common_types.h"
 #include "core/arm/arm_interface.h"
@@ -67,14 +67,23 @@ private:
     Memory::MemorySystem& memory;
     std::unique_ptr<DynarmicUserCallbacks> cb;
     std::unique_ptr<Dynarmic::A32::Jit> MakeJit();
+    void ReleaseUnusedJits();
 
     u32 fpexc = 0;
     CP15State cp15_state;
     Core::DynarmicExclusiveMonitor& exclusive_monitor;
 
+    /// JIT of a page table. The JIT does not own the page table, so that it is released together
+    /// with the process the page table belongs to.
+    struct JitEntry {
+        const Memory::PageTable* page_table;
+        std::weak_ptr<Memory::PageTable> owner;
+        std::unique_ptr<Dynarmic::A32::Jit> jit;
+    };
+
     Dynarmic::A32::Jit* jit = nullptr;
     std::shared_ptr<Memory::PageTable> current_page_table = nullptr;
-    std::map<std::shared_ptr<Memory::PageTable>, std::unique_ptr<Dynarmic::A32::Jit>> jits;
+    std::vector<JitEntry> jits;
 };
 
 } // namespace Core
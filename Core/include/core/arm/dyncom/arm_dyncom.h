@@ -25,6 +25,9 @@ public:
                         std::shared_ptr<Core::Timing::Timer> timer);
     ~ARM_DynCom() override;
 
+    /// Returns the host memory resident for the translation cache shared by the cores.
+    static std::size_t GetTranslationCacheResidentSize();
+
     void Run() override;
     void Step() override;
 
@@ -6,6 +6,7 @@
 
 #include <cstddef>
 #include "common/common_types.h"
+#include "common/virtual_buffer.h"
 
 struct ARMul_State;
 typedef unsigned int (*shtop_fp_t)(ARMul_State* cpu, unsigned int sht_oper);
@@ -494,5 +495,15 @@ extern const transop_fp_t arm_instruction_trans[];
 extern const std::size_t arm_instruction_trans_len;
 
 #define TRANS_CACHE_SIZE (64 * 1024 * 2000)
-extern char trans_cache_buf[TRANS_CACHE_SIZE];
+extern Common::VirtualBuffer<char> trans_cache_buf;
 extern std::size_t trans_cache_buf_top;
+/// Incremented every time the translation cache is emptied, see ARMul_State::trans_cache_generation
+extern u32 trans_cache_generation;
+
+/// Requests the translation cache to be emptied. The running core may still be inside one of the
+/// translated blocks, so it is only emptied by the next call to ApplyTransCacheClear.
+void ClearTransCache();
+
+/// Empties the translation cache if requested and returns the host memory used by it to the
+/// system. Must only be called while no core is executing translated blocks.
+void ApplyTransCacheClear();
@@ -255,6 +255,9 @@ public:
     // TODO(bunnei): Move this cache to a better place - it should be per codeset (likely per
     // process for our purposes), not per ARMul_State (which tracks CPU core state).
     std::unordered_map<u32, std::size_t> instruction_cache;
+    // The translation cache is shared by all cores. When it is emptied the generation changes and
+    // the instruction cache is dropped on the next block lookup.
+    u32 trans_cache_generation = 0;
 
 private:
     void ResetMPCoreCP15Registers();
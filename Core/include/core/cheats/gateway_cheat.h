@@ -79,10 +79,28 @@ public:
     /// This function will pares the file for such structures
     static std::vector<std::shared_ptr<CheatBase>> LoadFile(const std::string& filepath);
 
+    /// A cheat line decoded ahead of time. The lines holding patch data are folded into the
+    /// patch op that owns them.
+    struct CompiledOp {
+        CheatType type;
+        u32 address;
+        u32 value;
+        /// Conditionals: op at which a failed condition resumes and the if depth at that op
+        u32 skip_target;
+        u32 skip_depth;
+        /// Patch: index of the first data word in patch_words
+        u32 patch_begin;
+    };
+
 private:
+    /// Decodes cheat_lines into ops, called once when the cheat is created.
+    void Compile();
+
     std::atomic<bool> enabled = false;
     const std::string name;
     std::vector<CheatLine> cheat_lines;
+    std::vector<CompiledOp> ops;
+    std::vector<u32> patch_words;
     const std::string comments;
 };
 } // namespace Cheats
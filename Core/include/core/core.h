@@ -76,6 +76,15 @@ class TelemetrySession;
 class ExclusiveMonitor;
 class Timing;
 
+/// Host memory resident for the emulation session, in bytes.
+struct ResidentMemory {
+    u64 process;           ///< The whole emulator process
+    u64 fcram;             ///< Emulated FCRAM
+    u64 vram;              ///< Emulated VRAM
+    u64 n3ds_extra_ram;    ///< Emulated New 3DS extra RAM
+    u64 translation_cache; ///< Instruction translation cache of the interpreter
+};
+
 class System {
 public:
     /**
@@ -192,6 +201,9 @@ public:
     }
 
     [[nodiscard]] PerfStats::Results GetLastPerfStats();
+
+    /// Returns the host memory resident for the emulated subsystems.
+    [[nodiscard]] ResidentMemory GetResidentMemory() const;
     
     double GetStableFrameTimeScale();
 
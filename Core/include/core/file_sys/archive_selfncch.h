@@ -46,6 +46,12 @@ public:
     /// Registers a loaded application so that we can open its SelfNCCH archive when requested.
     void Register(Loader::AppLoader& app_loader);
 
+    /// Registers the contents read by ReadNCCHData as the SelfNCCH archive of the program.
+    void Register(u64 program_id, NCCHData data);
+
+    /// Reads the RomFS, icon, logo and banner of a loaded application without registering them.
+    static NCCHData ReadNCCHData(Loader::AppLoader& app_loader);
+
     std::string GetName() const override {
         return "SelfNCCH";
     }
@@ -253,6 +253,7 @@ public:
 
     /**
      * Reads an application ExeFS section of an NCCH file (e.g. .code, .logo, etc.)
+     * Sections can be read from several threads at once after the container was loaded.
      * @param name Name of section to read out of NCCH file
      * @param buffer Vector to read data into
      * @return ResultStatus result of function
@@ -362,6 +363,7 @@ private:
     std::string filepath;
     FileUtil::IOFile file;
     FileUtil::IOFile exefs_file;
+    std::string exefs_filepath; // Sections are read through their own handles to this file
 };
 
 } // namespace FileSys
@@ -63,6 +63,12 @@ bool IsServerEnabled();
 /// Returns true if there is an active socket connection.
 bool IsConnected();
 
+/**
+ * Returns true if the emulation thread has to call HandlePacket, because a command from the
+ * client is queued, the CPU is halted or the deferred start of the server is pending.
+ */
+bool HasPendingWork();
+
 /**
  * Signal to the gdbstub server that it should halt CPU execution.
  *
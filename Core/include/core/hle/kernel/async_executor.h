@@ -0,0 +1,79 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include "common/common_types.h"
+#include "common/thread_worker.h"
+#include "common/unique_function.h"
+
+namespace Kernel {
+
+/// Kind of work queued by HLERequestContext::RunAsync, every class has its own set of workers.
+enum class AsyncClass : u32 {
+    Storage, ///< File system and title I/O, which always completes
+    Network, ///< Socket and HTTP requests, which may block until the other end responds
+    Count,
+};
+
+/**
+ * Completion of the asynchronous section of a request. Saving the state waits for it, as the
+ * section may still write to the request context.
+ */
+class AsyncCompletion {
+public:
+    /// Marks the section as running.
+    void Reset() {
+        std::scoped_lock lock{mutex};
+        done = false;
+    }
+
+    /// Marks the section as finished and wakes up the waiting threads.
+    void Signal() {
+        {
+            std::scoped_lock lock{mutex};
+            done = true;
+        }
+        cv.notify_all();
+    }
+
+    /// Blocks until the section has finished.
+    void Wait() {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [this] { return done; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool done = true;
+};
+
+/**
+ * Runs the asynchronous sections of HLE service requests on a bounded set of reused host threads
+ * per class, instead of creating a thread for each request. The workers of a class are created
+ * the first time work of that class is queued.
+ */
+class AsyncExecutor {
+public:
+    AsyncExecutor();
+    ~AsyncExecutor();
+
+    AsyncExecutor(const AsyncExecutor&) = delete;
+    AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+
+    /// Queues work to run on one of the workers of the class.
+    void QueueWork(AsyncClass async_class, Common::UniqueFunction<void> work);
+
+private:
+    std::mutex mutex;
+    std::array<std::unique_ptr<Common::ThreadWorker>, static_cast<std::size_t>(AsyncClass::Count)>
+        workers;
+};
+
+} // namespace Kernel
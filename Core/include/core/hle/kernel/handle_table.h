@@ -88,6 +88,23 @@ public:
         return DynamicObjectCast<T>(GetGeneric(handle));
     }
 
+    /**
+     * Looks up a handle without taking a reference to the object. The pointer stays valid only
+     * while the handle is open, so it must not be kept past the current SVC.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid.
+     */
+    Object* GetGenericBorrowed(Handle handle) const;
+
+    /**
+     * Looks up a handle while verifying its type, without taking a reference to the object.
+     * @return Pointer to the looked-up object, or `nullptr` if the handle is not valid or its
+     *         type differs from the requested one.
+     */
+    template <class T>
+    T* GetBorrowed(Handle handle) const {
+        return DynamicObjectCast<T>(GetGenericBorrowed(handle));
+    }
+
     /// Closes all handles held in this table.
     void Clear();
 
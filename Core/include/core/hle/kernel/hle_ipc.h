@@ -7,7 +7,6 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
-#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -17,6 +16,7 @@
 #include "common/serialization/boost_small_vector.hpp"
 #include "common/swap.h"
 #include "core/hle/ipc.h"
+#include "core/hle/kernel/async_executor.h"
 #include "core/hle/kernel/object.h"
 #include "core/hle/kernel/server_session.h"
 
@@ -257,24 +257,25 @@ private:
     template <typename ResultFunctor>
     class AsyncWakeUpCallback : public WakeupCallback {
     public:
-        explicit AsyncWakeUpCallback(ResultFunctor res_functor, std::future<void> fut)
-            : functor(res_functor) {
-            future = std::move(fut);
-        }
+        explicit AsyncWakeUpCallback(ResultFunctor res_functor) : functor(res_functor) {}
 
         void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
                     Kernel::ThreadWakeupReason reason) {
             functor(ctx);
         }
 
+        AsyncCompletion& Completion() {
+            return completion;
+        }
+
     private:
         ResultFunctor functor;
-        std::future<void> future;
+        AsyncCompletion completion;
 
         template <class Archive>
         void serialize(Archive& ar, const unsigned int) {
-            if (!Archive::is_loading::value && future.valid()) {
-                future.wait();
+            if (!Archive::is_loading::value) {
+                completion.Wait();
             }
             ar & functor;
         }
@@ -295,26 +296,28 @@ public:
      * and can be used to set the IPC result.
      * @param really_async If set to false, it will call both async_section and result_function
      * from the emulator thread.
+     * @param async_class Class of workers async_section runs on. Requests that may block until
+     * the guest does something else must use AsyncClass::Network.
      */
     template <typename AsyncFunctor, typename ResultFunctor>
     void RunAsync(AsyncFunctor async_section, ResultFunctor result_function,
-                  bool really_async = true) {
+                  bool really_async = true, AsyncClass async_class = AsyncClass::Storage) {
 
         if (really_async) {
-            this->SleepClientThread(
-                "RunAsync", std::chrono::nanoseconds(-1),
-                std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
-                    result_function,
-                    std::move(std::async(std::launch::async, [this, async_section] {
-                        s64 sleep_for = async_section(*this);
-                        this->thread->WakeAfterDelay(sleep_for, true);
-                    }))));
+            auto callback = std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(result_function);
+            callback->Completion().Reset();
+            this->SleepClientThread("RunAsync", std::chrono::nanoseconds(-1), callback);
+            QueueAsyncWork(async_class, [this, async_section, callback] {
+                s64 sleep_for = async_section(*this);
+                this->thread->WakeAfterDelay(sleep_for, true);
+                callback->Completion().Signal();
+            });
 
         } else {
             s64 sleep_for = async_section(*this);
             if (sleep_for > 0) {
-                auto parallel_wakeup = std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(
-                    result_function, std::move(std::future<void>()));
+                auto parallel_wakeup =
+                    std::make_shared<AsyncWakeUpCallback<ResultFunctor>>(result_function);
                 this->SleepClientThread("RunAsync", std::chrono::nanoseconds(sleep_for),
                                         parallel_wakeup);
             } else {
@@ -373,6 +376,9 @@ public:
     friend class ThreadCallback;
 
 private:
+    /// Queues the asynchronous section of a request on the executor of the kernel.
+    void QueueAsyncWork(AsyncClass async_class, Common::UniqueFunction<void> work);
+
     KernelSystem& kernel;
     std::array<u32, IPC::COMMAND_BUFFER_LENGTH> cmd_buf;
     std::shared_ptr<ServerSession> session;
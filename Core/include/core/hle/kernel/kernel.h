@@ -58,6 +58,7 @@ class ResourceLimitList;
 class SharedMemory;
 class ThreadManager;
 class TimerManager;
+class AsyncExecutor;
 class VMManager;
 struct AddressMapping;
 
@@ -289,6 +290,8 @@ public:
     TimerManager& GetTimerManager();
     const TimerManager& GetTimerManager() const;
 
+    AsyncExecutor& GetAsyncExecutor();
+
     void MapSharedPages(VMManager& address_space);
 
     SharedPage::Handler& GetSharedPageHandler();
@@ -385,6 +388,9 @@ private:
     MemoryMode memory_mode;
     New3dsHwCapabilities n3ds_hw_caps;
 
+    // Reset first by the destructor, so no asynchronous request outlives the state it wakes up.
+    std::unique_ptr<AsyncExecutor> async_executor;
+
     /*
      * Synchronizes access to the internal HLE kernel structures, it is acquired when a guest
      * application thread performs a syscall. It should be acquired by any host threads that read or
@@ -51,6 +51,7 @@ public:
 
     void AddWaitingThread(std::shared_ptr<Thread> thread) override;
     void RemoveWaitingThread(Thread* thread) override;
+    void RemoveWokenThreads(std::span<Thread* const> threads) override;
 
     /**
      * Attempts to release the mutex from the specified thread.
@@ -137,10 +137,11 @@ private:
 
     /**
      * Callback that will wake up the thread it was scheduled for
-     * @param thread_id The ID of the thread that's been awoken
+     * @param userdata The ID of the thread that's been awoken in the low word, and its wakeup
+     *                 sequence when the event was scheduled in the high word
      * @param cycles_late The number of CPU cycles that have passed since the desired wakeup time
      */
-    void ThreadWakeupCallback(u64 thread_id, s64 cycles_late);
+    void ThreadWakeupCallback(u64 userdata, s64 cycles_late);
 
     Kernel::KernelSystem& kernel;
     Core::ARM_Interface* cpu;
@@ -231,6 +232,9 @@ public:
      */
     void WakeAfterDelay(s64 nanoseconds, bool thread_safe_mode = false);
 
+    /// Removes the wakeup event of the last timed wait from the event queue if it has not fired.
+    void CancelWakeup();
+
     /**
      * Sets the result after the thread awakens (from either WaitSynchronization SVC)
      * @param result Value to set to the returned result
@@ -321,6 +325,16 @@ public:
     /// available. In case of a timeout, the object will be nullptr.
     std::shared_ptr<WakeupCallback> wakeup_callback{};
 
+    /// Incremented every time the thread stops waiting. Wakeup events carry the value at the time
+    /// they were scheduled, so the events of a finished wait are ignored when they fire. Events
+    /// still queued are also cancelled when the thread next runs or exits, so at most one stale
+    /// event per thread stays in the queue.
+    u32 wakeup_sequence{};
+
+    /// Whether the wakeup event of the last timed wait is still queued, and its user data
+    bool wakeup_event_pending{};
+    u64 wakeup_event_userdata{};
+
     const u32 core_id;
 
 private:
@@ -346,6 +360,7 @@ std::shared_ptr<Thread> SetupMainThread(KernelSystem& kernel, u32 entry_point, u
 
 BOOST_CLASS_EXPORT_KEY(Kernel::Thread)
 BOOST_CLASS_EXPORT_KEY(Kernel::WakeupCallback)
+BOOST_CLASS_VERSION(Kernel::Thread, 1)
 
 namespace boost::serialization {
 
@@ -6,6 +6,7 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 #include <vector>
 #include "common/common_types.h"
 #include "core/hle/kernel/object.h"
@@ -41,6 +42,13 @@ public:
      */
     virtual void RemoveWaitingThread(Thread* thread);
 
+    /**
+     * Removes the woken up threads from waiting on this object in a single pass. Threads that
+     * started waiting on this object again are kept.
+     * @param threads Woken up threads, sorted by address
+     */
+    virtual void RemoveWokenThreads(std::span<Thread* const> threads);
+
     /**
      * Wake up all threads waiting on this object that can be awoken, in priority order,
      * and set the synchronization result and output of the thread.
@@ -57,6 +65,17 @@ public:
     void SetHLENotifier(std::function<void()> callback);
 
 private:
+    /// Returns true if the waiting thread can acquire this and every other object it waits for.
+    bool IsReadyToRun(const Thread* thread) const;
+
+    /// Acquires the objects the thread waits for and resumes it.
+    void WakeupThread(std::shared_ptr<Thread> thread);
+
+    /// Like WakeupThread, but returns the objects the thread waited for instead of removing the
+    /// thread from their waiting lists.
+    std::vector<std::shared_ptr<WaitObject>> ResumeWaitingThread(
+        const std::shared_ptr<Thread>& thread);
+
     /// Threads waiting for this object to become available
     std::vector<std::shared_ptr<Thread>> waiting_threads;
 
@@ -78,6 +97,14 @@ inline std::shared_ptr<WaitObject> DynamicObjectCast<WaitObject>(std::shared_ptr
     return nullptr;
 }
 
+template <>
+inline WaitObject* DynamicObjectCast<WaitObject>(Object* object) {
+    if (object != nullptr && object->IsWaitable()) {
+        return static_cast<WaitObject*>(object);
+    }
+    return nullptr;
+}
+
 } // namespace Kernel
 
 BOOST_CLASS_EXPORT_KEY(Kernel::WaitObject)
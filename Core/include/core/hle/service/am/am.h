@@ -8,6 +8,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/shared_ptr.hpp>
@@ -789,9 +790,23 @@ private:
      */
     void ScanForAllTitles();
 
+    /// Loads the contents known to be valid titles from the previous scans.
+    void LoadTitleScanCache();
+
+    /// Writes the contents known to be valid titles to the cache directory.
+    void SaveTitleScanCache();
+
+    /// Content of a title that loaded successfully, keyed by its path in the title scan cache.
+    struct TitleScanCacheEntry {
+        u64 size;
+        s64 modification_time;
+    };
+
     Core::System& system;
     bool cia_installing = false;
     std::array<std::vector<u64_le>, 3> am_title_list;
+    std::unordered_map<std::string, TitleScanCacheEntry> title_scan_cache;
+    bool title_scan_cache_dirty = false;
     std::shared_ptr<Kernel::Mutex> system_updater_mutex;
     CTCert ct_cert{};
 
@@ -23,6 +23,10 @@ static constexpr char SYSTEM_ID[]{"00000000000000000000000000000000"};
 /// The scrambled SD card CID, also known as ID1
 static constexpr char SDCARD_ID[]{"00000000000000000000000000000000"};
 
+namespace FileSys {
+struct NCCHData;
+}
+
 namespace Loader {
 class AppLoader;
 }
@@ -291,6 +295,10 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /// Registers contents read by ArchiveFactory_SelfNCCH::ReadNCCHData with the SelfNCCH archive
+    /// factory
+    void RegisterSelfNCCH(u64 program_id, FileSys::NCCHData data);
+
     void RegisterArticSaveDataSource(std::shared_ptr<Network::ArticBase::Client>& client);
 
     void RegisterArticExtData(std::shared_ptr<Network::ArticBase::Client>& client);
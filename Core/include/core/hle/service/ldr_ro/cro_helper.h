@@ -5,7 +5,9 @@
 #pragma once
 
 #include <array>
+#include <string>
 #include <tuple>
+#include <unordered_map>
 #include "common/common_types.h"
 #include "common/swap.h"
 #include "core/hle/result.h"
@@ -27,12 +29,43 @@ namespace Service::LDR {
 static constexpr u32 CRO_HEADER_SIZE = 0x138;
 static constexpr u32 CRO_HASH_SIZE = 0x80;
 
+/**
+ * Host side copy of the named exports of the loaded modules of a process, keyed by module address.
+ * Linking looks every imported symbol up in every auto-link module, so resolving names here
+ * instead of walking the export trees in guest memory keeps linking large module sets fast.
+ * Modules that are not indexed, such as those loaded before a save state was restored, fall back
+ * to the export tree.
+ */
+class ExportSymbolIndex {
+public:
+    using SymbolMap = std::unordered_map<std::string, VAddr>;
+
+    void Add(VAddr module_address, SymbolMap symbols) {
+        modules.insert_or_assign(module_address, std::move(symbols));
+    }
+
+    void Remove(VAddr module_address) {
+        modules.erase(module_address);
+    }
+
+    /// Returns the symbols exported by the module, or nullptr if the module isn't indexed.
+    const SymbolMap* Find(VAddr module_address) const {
+        const auto it = modules.find(module_address);
+        return it != modules.end() ? &it->second : nullptr;
+    }
+
+private:
+    std::unordered_map<VAddr, SymbolMap> modules;
+};
+
 /// Represents a loaded module (CRO) with interfaces manipulating it.
 class CROHelper final {
 public:
     // TODO (wwylele): pass in the process handle for memory access
-    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Core::System& system)
-        : module_address(cro_address), process(process), system(system) {}
+    explicit CROHelper(VAddr cro_address, Kernel::Process& process, Core::System& system,
+                       ExportSymbolIndex* export_index = nullptr)
+        : module_address(cro_address), process(process), system(system),
+          export_index(export_index) {}
 
     std::string ModuleName() const {
         return system.Memory().ReadCString(GetField(ModuleNameOffset), GetField(ModuleNameSize));
@@ -142,6 +175,7 @@ private:
     const VAddr module_address; ///< the virtual address of this module
     Kernel::Process& process;   ///< the owner process of this module
     Core::System& system;
+    ExportSymbolIndex* export_index; ///< the export index of the process, may be null
 
     /**
      * Each item in this enum represents a u32 field in the header begin from address+0x80,
@@ -460,6 +494,7 @@ private:
     /**
      * A helper function iterating over all registered auto-link modules, including the static
      * module.
+     * @param export_index the export index passed on to the modules, may be null
      * @param crs_address the virtual address of the static module
      * @param func a function object to operate on a module. It accepts one parameter
      *        CROHelper and returns ResultVal<bool>. It should return true to continue the
@@ -471,10 +506,11 @@ private:
      */
     template <typename FunctionObject>
     static Result ForEachAutoLinkCRO(Kernel::Process& process, Core::System& system,
-                                     VAddr crs_address, FunctionObject func) {
+                                     ExportSymbolIndex* export_index, VAddr crs_address,
+                                     FunctionObject func) {
         VAddr current = crs_address;
         while (current != 0) {
-            CROHelper cro(current, process, system);
+            CROHelper cro(current, process, system, export_index);
             CASCADE_RESULT(bool next, func(cro));
             if (!next)
                 break;
@@ -521,6 +557,16 @@ private:
      */
     VAddr FindExportNamedSymbol(const std::string& name) const;
 
+    /**
+     * Finds an exported named symbol by walking the export tree in guest memory.
+     * @param name the name of the symbol to find
+     * @return VAddr the virtual address of the symbol; 0 if not found.
+     */
+    VAddr FindExportNamedSymbolInTree(const std::string& name) const;
+
+    /// Adds the named exports of this module to the export index.
+    void BuildExportSymbolIndex();
+
     /**
      * Rebases offsets in module header according to module address.
      * @param cro_size the size of the CRO file
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include "core/hle/service/ldr_ro/cro_helper.h"
 #include "core/hle/service/service.h"
 
 namespace Core {
@@ -13,7 +14,8 @@ class System;
 namespace Service::LDR {
 
 struct ClientSlot : public Kernel::SessionRequestHandler::SessionDataBase {
-    VAddr loaded_crs = 0; ///< the virtual address of the static module
+    VAddr loaded_crs = 0;           ///< the virtual address of the static module
+    ExportSymbolIndex export_index; ///< named exports of the loaded modules, not serialized
 
 private:
     template <class Archive>
@@ -14,6 +14,7 @@
 #include <mutex>
 #include <unordered_map>
 #include <vector>
+#include <boost/container/static_vector.hpp>
 #include <boost/optional.hpp>
 #include <boost/serialization/export.hpp>
 #include "common/common_types.h"
@@ -47,6 +48,13 @@ const u16 DefaultBeaconInterval = 100;
 /// The maximum number of nodes that can exist in an UDS session.
 constexpr u32 UDSMaxNodes = 16;
 
+// Number of beacons to store before we start dropping the old ones.
+// TODO(Subv): Find a more accurate value for this limit.
+constexpr std::size_t MaxBeaconFrames = 15;
+
+/// Fixed-capacity storage for the beacons received from the network, oldest first.
+using BeaconList = boost::container::static_vector<Network::WifiPacket, MaxBeaconFrames>;
+
 struct NodeInfo {
     u64_le friend_code_seed;
     std::array<u16_le, 10> username;
@@ -461,7 +469,7 @@ private:
      * Returns a list of received 802.11 beacon frames from the specified sender since the last
      * call.
      */
-    std::list<Network::WifiPacket> GetReceivedBeacons(const MacAddress& sender);
+    BeaconList GetReceivedBeacons(const MacAddress& sender);
 
     /*
      * Returns an available index in the nodes array for the
@@ -526,13 +534,21 @@ private:
     // Node information about our own system.
     NodeInfo current_node;
 
+    /// A data frame queued on a bind node, with its SecureData header already parsed.
+    struct ReceivedDataFrame {
+        u16 src_node_id;         ///< Network node id of the sender.
+        std::vector<u8> payload; ///< Frame payload, without the LLC and SecureData headers.
+    };
+
     struct BindNodeData {
         u32 bind_node_id;    ///< Id of the bind node associated with this data.
         u8 channel;          ///< Channel that this bind node was bound to.
         u16 network_node_id; ///< Node id this bind node is associated with, only packets from this
                              /// network node will be received.
-        std::shared_ptr<Kernel::Event> event;         ///< Receive event for this bind node.
-        std::deque<std::vector<u8>> received_packets; ///< List of packets received on this channel.
+        std::shared_ptr<Kernel::Event> event; ///< Receive event for this bind node.
+        u32 recv_buffer_size;                 ///< Size of the receive buffer requested at Bind.
+        std::size_t pending_bytes = 0;        ///< Payload bytes currently held in the queue.
+        std::deque<ReceivedDataFrame> received_packets; ///< Frames received on this channel.
     };
 
     // Mapping of data channels to their internal data.
@@ -577,8 +593,8 @@ private:
     // the network thread.
     std::mutex beacon_mutex;
 
-    // List of the last <MaxBeaconFrames> beacons received from the network.
-    std::list<Network::WifiPacket> received_beacons;
+    // The last <MaxBeaconFrames> beacons received from the network, oldest first.
+    BeaconList received_beacons;
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int);
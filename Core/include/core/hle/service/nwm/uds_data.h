@@ -127,6 +127,12 @@ std::vector<u8> GenerateDataPayload(std::span<const u8> data, u8 channel, u16 de
  */
 SecureDataHeader ParseSecureDataHeader(std::span<const u8> data);
 
+/*
+ * Returns a view of the payload stored in an 802.11 data frame, past the LLC and SecureData
+ * headers. The view is clamped to the size of the frame.
+ */
+std::span<const u8> GetSecureDataPayload(std::span<const u8> data, const SecureDataHeader& header);
+
 /*
  * Generates an unencrypted 802.11 data frame body with the EAPoL-Start format for UDS
  * communication.
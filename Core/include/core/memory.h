@@ -235,6 +235,13 @@ enum class FlushMode {
     FlushAndInvalidate,
 };
 
+/// Host memory resident for the emulated memory regions, in bytes.
+struct MemoryFootprint {
+    u64 fcram;
+    u64 vram;
+    u64 n3ds_extra_ram;
+};
+
 class MemorySystem {
 public:
     explicit MemorySystem(Core::System& system);
@@ -513,6 +520,9 @@ public:
      * @param size   The size of the address range in bytes.
      * @param cached Whether or not any pages within the address range should be
      *               marked as cached or uncached.
+     *
+     * When called from the GPU thread the mark is queued, and applied on the emulation thread by
+     * RasterizerApplyCacheMarks.
      */
     void RasterizerMarkRegionCached(PAddr start, u32 size, bool cached);
 
@@ -543,6 +553,12 @@ public:
     /// Gets a serializable ref to FCRAM with the given offset
     MemoryRef GetFCRAMRef(std::size_t offset) const;
 
+    /// Zeroes a range of FCRAM, returning the host memory backing it to the system.
+    void ClearFCRAM(std::size_t offset, std::size_t size);
+
+    /// Returns the host memory resident for the emulated memory regions.
+    MemoryFootprint GetFootprint() const;
+
     /// Registers page table for rasterizer cache marking
     void RegisterPageTable(std::shared_ptr<PageTable> page_table);
 
@@ -553,7 +569,29 @@ public:
 
     void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode);
 
+    /**
+     * Invalidates the rasterizer cache for the CPU writes to cached pages recorded since the last
+     * call. Writes are deferred to coalesce stores to the same range, this must be called before
+     * the GPU accesses guest memory.
+     */
+    void RasterizerCommitWrites();
+
+    /**
+     * Called by the rasterizer before it writes flushed data to guest memory. On the GPU thread,
+     * CPU writes to the range wait until RasterizerEndFlush, and the CPU writes that are still
+     * pending in it are restored afterwards.
+     */
+    void RasterizerBeginFlush(PAddr start, u32 size);
+
+    /// Called by the rasterizer once it has written flushed data to guest memory.
+    void RasterizerEndFlush();
+
+    /// Applies the cache marks queued by the GPU thread to the page tables.
+    void RasterizerApplyCacheMarks();
+
 private:
+    void MarkRegionCached(PAddr start, u32 size, bool cached);
+
     template <typename T>
     T Read(const VAddr vaddr);
 
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -28,10 +30,41 @@ struct PortInfo;
 struct Version;
 } // namespace Response
 
+/// A motion sample reported by the server, stamped with the host time it was measured at.
+struct MotionSample {
+    std::chrono::steady_clock::time_point timestamp{};
+    Common::Vec3<float> accel{};
+    Common::Vec3<float> gyro{};
+};
+
 struct DeviceStatus {
-    std::mutex update_mutex;
-    std::tuple<Common::Vec3<float>, Common::Vec3<float>> motion_status;
-    std::tuple<float, float, bool> touch_status;
+    using Clock = std::chrono::steady_clock;
+
+    /// State published by the socket thread for the input devices to consume.
+    struct Snapshot {
+        MotionSample previous_motion{};
+        MotionSample motion{};
+        std::tuple<float, float, bool> touch_status{};
+    };
+
+    /**
+     * Publishes a new snapshot. Only the socket thread of the owning client may call this, readers
+     * never block it.
+     */
+    void Publish(const Snapshot& snapshot);
+
+    /// Returns the most recently published snapshot without taking a lock.
+    Snapshot Read() const;
+
+    /**
+     * Returns the motion status at the given host time, interpolated along the line through the
+     * two most recent samples. The estimate never runs more than one sample period past the latest
+     * sample, after which the latest sample is held.
+     */
+    std::tuple<Common::Vec3<float>, Common::Vec3<float>> GetMotionStatus(
+        Clock::time_point now) const;
+
+    std::tuple<float, float, bool> GetTouchStatus() const;
 
     // calibration data for scaling the device's touch area to 3ds
     struct CalibrationData {
@@ -40,7 +73,13 @@ struct DeviceStatus {
         u16 max_x{};
         u16 max_y{};
     };
+    std::mutex calibration_mutex;
     std::optional<CalibrationData> touch_calibration;
+
+private:
+    /// Sequence counter of the snapshot, odd while the writer is updating it.
+    std::atomic<u32> sequence{0};
+    Snapshot snapshot{};
 };
 
 class Client {
@@ -61,6 +100,11 @@ private:
     std::shared_ptr<DeviceStatus> status;
     std::thread thread;
     u64 packet_sequence = 0;
+
+    /// Last published state, only touched by the socket thread.
+    DeviceStatus::Snapshot current_snapshot{};
+    /// Offset that maps the server motion timestamps onto the host clock.
+    std::optional<DeviceStatus::Clock::duration> timestamp_offset;
 };
 
 /// An async job allowing configuration of the touchpad calibration.
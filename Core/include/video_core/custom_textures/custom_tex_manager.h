@@ -8,7 +8,7 @@
 #include <span>
 #include <unordered_map>
 #include <unordered_set>
-#include "common/thread_worker.h"
+#include "common/task_scheduler.h"
 #include "video_core/custom_textures/material.h"
 #include "video_core/rasterizer_interface.h"
 
@@ -25,10 +25,17 @@ namespace VideoCore {
 class SurfaceParams;
 
 struct AsyncUpload {
-    const Material* material;
+    Material* material;
     std::function<bool()> func;
 };
 
+struct CustomTexStats {
+    u64 hits;
+    u64 misses;
+    u64 evictions;
+    u64 bytes_resident;
+};
+
 class CustomTexManager {
 public:
     explicit CustomTexManager(Core::System& system);
@@ -69,6 +76,16 @@ public:
         return use_new_hash;
     }
 
+    /// Returns true if the pack is keyed on XXH3 instead of the legacy CityHash64.
+    bool UseFastHash() const noexcept {
+        return use_fast_hash;
+    }
+
+    /// Returns the residency counters of the decoded materials.
+    const CustomTexStats& GetStats() const noexcept {
+        return stats;
+    }
+
 private:
     /// Parses the custom texture filename (hash, material type, etc).
     bool ParseFilename(const FileUtil::FSTEntry& file, CustomTexture* texture);
@@ -79,6 +96,16 @@ private:
     /// Creates the thread workers.
     void CreateWorkers();
 
+    /// Marks the decoded material as the most recently used one and enforces the memory budget.
+    void MakeResident(Material* material);
+
+    /// Evicts the least recently used materials until the resident bytes fit the budget.
+    void EvictToBudget();
+
+    /// Collects material and every material sharing maps with it. Returns false if any of them
+    /// is still being decoded or waiting for upload.
+    bool CollectEvictionGroup(Material* material, std::vector<Material*>& group);
+
 private:
     Core::System& system;
     Frontend::ImageInterface& image_interface;
@@ -87,12 +114,16 @@ private:
     std::unordered_map<std::string, std::vector<u64>> path_to_hash_map;
     std::vector<std::unique_ptr<CustomTexture>> custom_textures;
     std::list<AsyncUpload> async_uploads;
-    std::unique_ptr<Common::ThreadWorker> workers;
+    std::list<Material*> resident_materials;
+    CustomTexStats stats{};
+    u64 memory_budget;
+    std::unique_ptr<Common::TaskGroup> workers;
     bool textures_loaded{false};
     bool async_custom_loading{true};
     bool skip_mipmap{false};
     bool flip_png_files{true};
     bool use_new_hash{true};
+    bool use_fast_hash{false};
 };
 
 } // namespace VideoCore
@@ -4,8 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <list>
 #include <mutex>
 #include <span>
 #include <string>
@@ -37,7 +39,11 @@ public:
     explicit CustomTexture(Frontend::ImageInterface& image_interface);
     ~CustomTexture();
 
-    void LoadFromDisk(bool flip_png);
+    /// Decodes the texture file. Returns true if the texture was decoded by this call.
+    bool LoadFromDisk(bool flip_png);
+
+    /// Releases the decoded texture data.
+    void Unload();
 
     [[nodiscard]] bool IsParsed() const noexcept {
         return file_format != CustomFileFormat::None && !hashes.empty();
@@ -73,9 +79,13 @@ struct Material {
     CustomPixelFormat format;
     std::array<CustomTexture*, MAX_MAPS> textures;
     std::atomic<DecodeState> state{};
+    std::list<Material*>::iterator resident_entry{};
+    bool resident{false};
 
     void LoadFromDisk(bool flip_png) noexcept;
 
+    void Unload() noexcept;
+
     void AddMapTexture(CustomTexture* texture) noexcept;
 
     [[nodiscard]] CustomTexture* Map(MapType type) const noexcept {
@@ -97,6 +107,13 @@ struct Material {
     [[nodiscard]] bool IsUnloaded() const noexcept {
         return state == DecodeState::None;
     }
+
+    /// Returns true if any map of the material is also used by other materials.
+    [[nodiscard]] bool IsShared() const noexcept {
+        return std::ranges::any_of(textures, [](const CustomTexture* texture) {
+            return texture && texture->hashes.size() > 1;
+        });
+    }
 };
 
 } // namespace VideoCore
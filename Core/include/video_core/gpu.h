@@ -8,6 +8,7 @@
 #include <memory>
 #include <boost/serialization/access.hpp>
 
+#include "common/unique_function.h"
 #include "core/hle/service/gsp/gsp_interrupt.h"
 
 namespace Service::GSP {
@@ -77,6 +78,14 @@ public:
     /// Synchronizes fixed function renderer state with PICA registers.
     void Sync();
 
+    /// Blocks until the GPU thread has completed all submitted work, so the rasterizer can be
+    /// accessed from the calling thread. Does nothing when the GPU runs on the emulation thread.
+    void WaitIdle();
+
+    /// Waits for the GPU thread and delivers the interrupts it has raised since. Must be called
+    /// from the emulation thread.
+    void Synchronize();
+
     /// Returns a mutable reference to the renderer.
     [[nodiscard]] VideoCore::RendererBase& Renderer();
 
@@ -93,6 +102,15 @@ public:
     [[nodiscard]] GraphicsDebugger& Debugger();
 
 private:
+    /// Runs GPU work on the GPU thread if there is one, or right away otherwise, after committing
+    /// the pending CPU writes to rasterizer cached memory. Returns the fence of the work.
+    u64 Dispatch(Common::UniqueFunction<void> work);
+
+    /// Signals an interrupt, deferring it to the emulation thread when raised on the GPU thread.
+    void SignalInterrupt(Service::GSP::InterruptId interrupt_id);
+
+    void DeliverInterrupts();
+
     void SubmitCmdList(u32 index);
 
     void MemoryFill(u32 index);
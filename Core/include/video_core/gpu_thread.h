@@ -0,0 +1,54 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "common/common_types.h"
+#include "common/polyfill_thread.h"
+#include "common/unique_function.h"
+
+namespace VideoCore {
+
+/**
+ * Runs the GPU work submitted by the emulation thread on a dedicated host thread, in submission
+ * order. Every submission returns a fence, which is reached once that work and all the work
+ * submitted before it have completed.
+ */
+class GPUThread {
+public:
+    GPUThread();
+    ~GPUThread();
+
+    GPUThread(const GPUThread&) = delete;
+    GPUThread& operator=(const GPUThread&) = delete;
+
+    /// Queues work to run on the GPU thread and returns its fence.
+    u64 Submit(Common::UniqueFunction<void> work);
+
+    /// Blocks until the fence has been reached. Returns immediately on the GPU thread itself.
+    void WaitForFence(u64 fence);
+
+    /// Blocks until all submitted work has completed. Returns immediately on the GPU thread itself.
+    void WaitIdle();
+
+    /// Returns true when called from a GPU thread.
+    [[nodiscard]] static bool IsGPUThread();
+
+private:
+    void ThreadLoop(std::stop_token stop_token);
+
+    std::mutex mutex;
+    std::condition_variable_any work_cv;
+    std::condition_variable fence_cv;
+    std::deque<Common::UniqueFunction<void>> queue;
+    std::atomic<u64> submitted_fence{};
+    std::atomic<u64> completed_fence{};
+    std::jthread thread;
+};
+
+} // namespace VideoCore
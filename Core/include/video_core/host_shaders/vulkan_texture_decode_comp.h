@@ -0,0 +1,255 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string_view>
+
+namespace HostShaders {
+// clang-format off
+constexpr std::string_view VULKAN_TEXTURE_DECODE_COMP = {
+"// Copyright 2024 Citra Emulator Project\n"
+"// Licensed under GPLv2 or any later version\n"
+"// Refer to the license.txt file included.\n"
+"\n"
+"#version 450 core\n"
+"\n"
+"// Detiles and decodes a morton tiled PICA texture into the linear layout produced by the CPU\n"
+"// decoder. Each invocation writes one word of the linear buffer.\n"
+"\n"
+"layout(local_size_x = 64, local_size_y = 1, local_size_z = 1) in;\n"
+"\n"
+"layout(binding = 0) readonly buffer InputBuffer {\n"
+"    uint words[];\n"
+"} tiled;\n"
+"\n"
+"layout(binding = 1) writeonly buffer OutputBuffer {\n"
+"    uint words[];\n"
+"} linear;\n"
+"\n"
+"layout(push_constant, std140) uniform DecodeInfo {\n"
+"    uint format;\n"
+"    uint width;\n"
+"    uint height;\n"
+"    uint bits_per_pixel;\n"
+"    uint linear_bytes_per_pixel;\n"
+"    uint raw;\n"
+"};\n"
+"\n"
+"const uint FORMAT_RGBA8 = 0u;\n"
+"const uint FORMAT_RGB8 = 1u;\n"
+"const uint FORMAT_RGB5A1 = 2u;\n"
+"const uint FORMAT_RGB565 = 3u;\n"
+"const uint FORMAT_RGBA4 = 4u;\n"
+"const uint FORMAT_IA8 = 5u;\n"
+"const uint FORMAT_RG8 = 6u;\n"
+"const uint FORMAT_I8 = 7u;\n"
+"const uint FORMAT_A8 = 8u;\n"
+"const uint FORMAT_IA4 = 9u;\n"
+"const uint FORMAT_I4 = 10u;\n"
+"const uint FORMAT_A4 = 11u;\n"
+"const uint FORMAT_ETC1 = 12u;\n"
+"const uint FORMAT_ETC1A4 = 13u;\n"
+"\n"
+"const uint ETC1_MODIFIERS[16] = uint[](2u, 8u, 5u, 17u, 9u, 29u, 13u, 42u, 18u, 60u, 24u, 80u,\n"
+"                                       33u, 106u, 47u, 183u);\n"
+"\n"
+"uint ReadByte(uint address) {\n"
+"    return bitfieldExtract(tiled.words[address >> 2], int((address & 3u) * 8u), 8);\n"
+"}\n"
+"\n"
+"uint ReadHalf(uint address) {\n"
+"    return ReadByte(address) | (ReadByte(address + 1u) << 8);\n"
+"}\n"
+"\n"
+"uint PackColor(uint r, uint g, uint b, uint a) {\n"
+"    return r | (g << 8) | (b << 16) | (a << 24);\n"
+"}\n"
+"\n"
+"uint Convert4To8(uint value) {\n"
+"    return (value << 4) | value;\n"
+"}\n"
+"\n"
+"uint Convert5To8(uint value) {\n"
+"    return ((value << 3) | (value >> 2)) & 0xFFu;\n"
+"}\n"
+"\n"
+"uint Convert6To8(uint value) {\n"
+"    return (value << 2) | (value >> 4);\n"
+"}\n"
+"\n"
+"uint MortonInterleave(uint x, uint y) {\n"
+"    const uint xi = (x & 1u) | ((x & 2u) << 1) | ((x & 4u) << 2);\n"
+"    const uint yi = ((y & 1u) << 1) | ((y & 2u) << 2) | ((y & 4u) << 3);\n"
+"    return xi | yi;\n"
+"}\n"
+"\n"
+"uint SampleETC1(uint lo, uint hi, uint x, uint y) {\n"
+"    const uint texel = 4u * x + y;\n"
+"    if ((hi & 1u) != 0u) {\n"
+"        const uint tmp = x;\n"
+"        x = y;\n"
+"        y = tmp;\n"
+"    }\n"
+"\n"
+"    int r;\n"
+"    int g;\n"
+"    int b;\n"
+"    if ((hi & 2u) != 0u) {\n"
+"        r = int(bitfieldExtract(hi, 27, 5));\n"
+"        g = int(bitfieldExtract(hi, 19, 5));\n"
+"        b = int(bitfieldExtract(hi, 11, 5));\n"
+"        if (x >= 2u) {\n"
+"            r += bitfieldExtract(int(hi), 24, 3);\n"
+"            g += bitfieldExtract(int(hi), 16, 3);\n"
+"            b += bitfieldExtract(int(hi), 8, 3);\n"
+"        }\n"
+"        r = int(Convert5To8(uint(r) & 0xFFu));\n"
+"        g = int(Convert5To8(uint(g) & 0xFFu));\n"
+"        b = int(Convert5To8(uint(b) & 0xFFu));\n"
+"    } else {\n"
+"        const int shift = x < 2u ? 4 : 0;\n"
+"        r = int(Convert4To8(bitfieldExtract(hi, 24 + shift, 4)));\n"
+"        g = int(Convert4To8(bitfieldExtract(hi, 16 + shift, 4)));\n"
+"        b = int(Convert4To8(bitfieldExtract(hi, 8 + shift, 4)));\n"
+"    }\n"
+"\n"
+"    const uint table_index = bitfieldExtract(hi, x < 2u ? 5 : 2, 3);\n"
+"    int modifier = int(ETC1_MODIFIERS[table_index * 2u + bitfieldExtract(lo, int(texel), 1)]);\n"
+"    if (bitfieldExtract(lo, int(texel) + 16, 1) != 0u) {\n"
+"        modifier = -modifier;\n"
+"    }\n"
+"\n"
+"    r = clamp(r + modifier, 0, 255);\n"
+"    g = clamp(g + modifier, 0, 255);\n"
+"    b = clamp(b + modifier, 0, 255);\n"
+"    return PackColor(uint(r), uint(g), uint(b), 0u);\n"
+"}\n"
+"\n"
+"uint TileOffset(uint x, uint y) {\n"
+"    const uint tile_index = (y / 8u) * (width / 8u) + x / 8u;\n"
+"    return tile_index * bits_per_pixel * 8u;\n"
+"}\n"
+"\n"
+"uint PixelAddress(uint x, uint y) {\n"
+"    return TileOffset(x, y) + MortonInterleave(x % 8u, y % 8u) * (bits_per_pixel / 8u);\n"
+"}\n"
+"\n"
+"uint DecodeETC1(uint x, uint y) {\n"
+"    const bool has_alpha = format == FORMAT_ETC1A4;\n"
+"    const uint subtile_size = has_alpha ? 16u : 8u;\n"
+"    const uint subtile_index = (x % 8u) / 4u + 2u * ((y % 8u) / 4u);\n"
+"    uint address = TileOffset(x, y) + subtile_index * subtile_size;\n"
+"    x %= 4u;\n"
+"    y %= 4u;\n"
+"\n"
+"    uint alpha = 255u;\n"
+"    if (has_alpha) {\n"
+"        const uint shift = 4u * (x * 4u + y);\n"
+"        const uint packed_alpha = tiled.words[(address >> 2) + shift / 32u];\n"
+"        alpha = Convert4To8(bitfieldExtract(packed_alpha, int(shift % 32u), 4));\n"
+"        address += 8u;\n"
+"    }\n"
+"\n"
+"    const uint index = address >> 2;\n"
+"    return SampleETC1(tiled.words[index], tiled.words[index + 1u], x, y) | (alpha << 24);\n"
+"}\n"
+"\n"
+"uint Decode4Bit(uint x, uint y) {\n"
+"    const uint morton = MortonInterleave(x % 8u, y % 8u);\n"
+"    const uint value = ReadByte(TileOffset(x, y) + (morton >> 1));\n"
+"    const uint pixel = Convert4To8((morton & 1u) != 0u ? value >> 4 : value & 0xFu);\n"
+"    if (format == FORMAT_I4) {\n"
+"        return PackColor(pixel, pixel, pixel, 255u);\n"
+"    }\n"
+"    return PackColor(0u, 0u, 0u, pixel);\n"
+"}\n"
+"\n"
+"uint DecodePixel(uint x, uint y) {\n"
+"    if (format == FORMAT_ETC1 || format == FORMAT_ETC1A4) {\n"
+"        return DecodeETC1(x, y);\n"
+"    }\n"
+"    if (format == FORMAT_I4 || format == FORMAT_A4) {\n"
+"        return Decode4Bit(x, y);\n"
+"    }\n"
+"\n"
+"    const uint address = PixelAddress(x, y);\n"
+"    switch (format) {\n"
+"    case FORMAT_RGBA8:\n"
+"        return PackColor(ReadByte(address + 3u), ReadByte(address + 2u), ReadByte(address + 1u),\n"
+"                         ReadByte(address));\n"
+"    case FORMAT_RGB8:\n"
+"        return PackColor(ReadByte(address + 2u), ReadByte(address + 1u), ReadByte(address), 255u);\n"
+"    case FORMAT_RGB5A1: {\n"
+"        const uint pixel = ReadHalf(address);\n"
+"        return PackColor(Convert5To8(bitfieldExtract(pixel, 11, 5)),\n"
+"                         Convert5To8(bitfieldExtract(pixel, 6, 5)),\n"
+"                         Convert5To8(bitfieldExtract(pixel, 1, 5)), (pixel & 1u) * 255u);\n"
+"    }\n"
+"    case FORMAT_RGB565: {\n"
+"        const uint pixel = ReadHalf(address);\n"
+"        return PackColor(Convert5To8(bitfieldExtract(pixel, 11, 5)),\n"
+"                         Convert6To8(bitfieldExtract(pixel, 5, 6)),\n"
+"                         Convert5To8(bitfieldExtract(pixel, 0, 5)), 255u);\n"
+"    }\n"
+"    case FORMAT_RGBA4: {\n"
+"        const uint pixel = ReadHalf(address);\n"
+"        return PackColor(Convert4To8(bitfieldExtract(pixel, 12, 4)),\n"
+"                         Convert4To8(bitfieldExtract(pixel, 8, 4)),\n"
+"                         Convert4To8(bitfieldExtract(pixel, 4, 4)),\n"
+"                         Convert4To8(bitfieldExtract(pixel, 0, 4)));\n"
+"    }\n"
+"    case FORMAT_IA8: {\n"
+"        const uint intensity = ReadByte(address + 1u);\n"
+"        return PackColor(intensity, intensity, intensity, ReadByte(address));\n"
+"    }\n"
+"    case FORMAT_RG8:\n"
+"        return PackColor(ReadByte(address + 1u), ReadByte(address), 0u, 255u);\n"
+"    case FORMAT_I8: {\n"
+"        const uint intensity = ReadByte(address);\n"
+"        return PackColor(intensity, intensity, intensity, 255u);\n"
+"    }\n"
+"    case FORMAT_A8:\n"
+"        return PackColor(0u, 0u, 0u, ReadByte(address));\n"
+"    case FORMAT_IA4: {\n"
+"        const uint value = ReadByte(address);\n"
+"        const uint intensity = Convert4To8(value >> 4);\n"
+"        return PackColor(intensity, intensity, intensity, Convert4To8(value & 0xFu));\n"
+"    }\n"
+"    }\n"
+"    return 0u;\n"
+"}\n"
+"\n"
+"void main() {\n"
+"    const uint word = gl_GlobalInvocationID.x;\n"
+"    const uint linear_size = width * height * linear_bytes_per_pixel;\n"
+"    if (word * 4u >= linear_size) {\n"
+"        return;\n"
+"    }\n"
+"\n"
+"    // The linear buffer is stored bottom up, the first row holds the last row of tiles.\n"
+"    if (raw == 0u) {\n"
+"        const uint x = word % width;\n"
+"        const uint y = height - 1u - word / width;\n"
+"        linear.words[word] = DecodePixel(x, y);\n"
+"        return;\n"
+"    }\n"
+"\n"
+"    uint value = 0u;\n"
+"    for (uint i = 0u; i < 4u; i++) {\n"
+"        const uint byte_index = word * 4u + i;\n"
+"        const uint pixel = byte_index / linear_bytes_per_pixel;\n"
+"        const uint x = pixel % width;\n"
+"        const uint y = height - 1u - pixel / width;\n"
+"        const uint address = PixelAddress(x, y) + byte_index % linear_bytes_per_pixel;\n"
+"        value |= ReadByte(address) << (i * 8u);\n"
+"    }\n"
+"    linear.words[word] = value;\n"
+"}\n"
+"\n"
+
+    // clang-format on
+};
+
+} // namespace HostShaders
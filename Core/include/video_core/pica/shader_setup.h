@@ -4,7 +4,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <optional>
+#include "common/common_types.h"
 #include "common/vector_math.h"
 #include "video_core/pica/packed_attribute.h"
 #include "video_core/pica_types.h"
@@ -46,6 +49,43 @@ private:
 
 struct ShaderRegs;
 
+/**
+ * Caches the hash of a shader memory array (program code or swizzle data) in blocks of 256 bytes.
+ * Writing a word only invalidates the block it belongs to, so patching a few instructions does not
+ * rehash the whole array. Blocks past the highest one ever written are known to be zero and are
+ * left out of the hash.
+ */
+class ShaderMemoryHash {
+public:
+    static constexpr u32 BlockWords = 64;
+    static constexpr u32 NumBlocks = MAX_PROGRAM_CODE_LENGTH / BlockWords;
+    static_assert(MAX_SWIZZLE_DATA_LENGTH / BlockWords == NumBlocks);
+
+    /// Invalidates the block containing the word at offset.
+    void MarkDirty(u32 offset) {
+        const u32 block = offset / BlockWords;
+        dirty_blocks |= u64{1} << block;
+        num_used_blocks = std::max(num_used_blocks, block + 1);
+    }
+
+    /// Invalidates every block, used after the memory was replaced as a whole.
+    void MarkAllDirty() {
+        dirty_blocks = ~u64{0};
+        num_used_blocks = NumBlocks;
+    }
+
+    /// Returns the hash of data, rehashing only the blocks written since the last call.
+    u64 Get(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>& data);
+
+private:
+    static_assert(NumBlocks == 64, "Dirty blocks are tracked with a 64-bit mask");
+
+    std::array<u64, NumBlocks> block_hashes{};
+    u64 dirty_blocks{~u64{0}};
+    u32 num_used_blocks{};
+    u64 hash{};
+};
+
 /**
  * This structure contains the state information common for all shader units such as uniforms.
  * The geometry shaders has a unique configuration so when enabled it has its own setup.
@@ -65,13 +105,11 @@ public:
 
     u64 GetSwizzleDataHash();
 
-    void MarkProgramCodeDirty() {
-        program_code_hash_dirty = true;
-    }
+    /// Writes a word of program code, invalidating its cached hash if the word changed.
+    void WriteProgramCode(u32 offset, u32 value);
 
-    void MarkSwizzleDataDirty() {
-        swizzle_data_hash_dirty = true;
-    }
+    /// Writes a swizzle pattern, invalidating its cached hash if the pattern changed.
+    void WriteSwizzleData(u32 offset, u32 value);
 
 public:
     Uniforms uniforms;
@@ -86,6 +124,8 @@ private:
     bool swizzle_data_hash_dirty{true};
     u64 program_code_hash{0xDEADC0DE};
     u64 swizzle_data_hash{0xDEADC0DE};
+    ShaderMemoryHash program_code_blocks;
+    ShaderMemoryHash swizzle_data_blocks;
 
     friend class boost::serialization::access;
     template <class Archive>
@@ -98,6 +138,12 @@ private:
         ar & swizzle_data_hash_dirty;
         ar & program_code_hash;
         ar & swizzle_data_hash;
+        if (Archive::is_loading::value) {
+            program_code_blocks.MarkAllDirty();
+            swizzle_data_blocks.MarkAllDirty();
+            program_code_hash_dirty = true;
+            swizzle_data_hash_dirty = true;
+        }
     }
 };
 
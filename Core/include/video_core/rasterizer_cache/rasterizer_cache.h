@@ -1009,17 +1009,22 @@ void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interva
     const SurfaceParams load_info = surface.FromInterval(interval);
     ASSERT(load_info.addr >= surface.addr && load_info.end <= surface.end);
 
-    const auto staging = runtime.FindStaging(
-        load_info.width * load_info.height * surface.GetInternalBytesPerPixel(), true);
-
     MemoryRef source_ptr = memory.GetPhysicalRef(load_info.addr);
     if (!source_ptr) [[unlikely]] {
         return;
     }
 
+    const u32 decoded_size =
+        load_info.width * load_info.height * surface.GetInternalBytesPerPixel();
     const auto upload_data = source_ptr.GetWriteBytes(load_info.end - load_info.addr);
-    DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
-                  runtime.NeedsConversion(surface.pixel_format));
+    StagingData staging;
+    if (runtime.CanDecodeOnGpu(load_info)) {
+        staging = runtime.DecodeOnGpu(load_info, upload_data, decoded_size);
+    } else {
+        staging = runtime.FindStaging(decoded_size, true);
+        DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, staging.mapped,
+                      runtime.NeedsConversion(surface.pixel_format));
+    }
 
     const bool should_dump = False(surface.flags & SurfaceFlagBits::Custom) &&
                              False(surface.flags & SurfaceFlagBits::RenderTarget);
@@ -1040,15 +1045,23 @@ void RasterizerCache<T>::UploadSurface(Surface& surface, SurfaceInterval interva
 
 template <class T>
 u64 RasterizerCache<T>::ComputeHash(const SurfaceParams& load_info, std::span<u8> upload_data) {
+    // Texture hashes name the files of custom texture packs, so packs keep the CityHash64 based
+    // hash unless they opt into the faster one.
+    const auto hash = [this](std::span<const u8> data) {
+        if (custom_tex_manager.UseFastHash()) {
+            return Common::ComputeHash64(data.data(), data.size());
+        }
+        return Common::ComputeLegacyHash64(data.data(), data.size());
+    };
     if (!custom_tex_manager.UseNewHash()) {
         const u32 width = load_info.width;
         const u32 height = load_info.height;
         const u32 bpp = GetFormatBytesPerPixel(load_info.pixel_format);
         auto decoded = std::vector<u8>(width * height * bpp);
         DecodeTexture(load_info, load_info.addr, load_info.end, upload_data, decoded, false);
-        return Common::ComputeHash64(decoded.data(), decoded.size());
+        return hash(decoded);
     } else {
-        return Common::ComputeHash64(upload_data.data(), upload_data.size());
+        return hash(upload_data);
     }
 }
 
@@ -1120,6 +1133,9 @@ void RasterizerCache<T>::DownloadSurface(Surface& surface, SurfaceInterval inter
     };
     surface.Download(download, staging);
 
+    memory.RasterizerBeginFlush(flush_start, flush_end - flush_start);
+    SCOPE_EXIT({ memory.RasterizerEndFlush(); });
+
     MemoryRef dest_ptr = memory.GetPhysicalRef(flush_start);
     if (!dest_ptr) [[unlikely]] {
         return;
@@ -1136,6 +1152,9 @@ void RasterizerCache<T>::DownloadFillSurface(Surface& surface, SurfaceInterval i
     const u32 flush_end = boost::icl::last_next(interval);
     ASSERT(flush_start >= surface.addr && flush_end <= surface.end);
 
+    memory.RasterizerBeginFlush(flush_start, flush_end - flush_start);
+    SCOPE_EXIT({ memory.RasterizerEndFlush(); });
+
     MemoryRef dest_ptr = memory.GetPhysicalRef(flush_start);
     if (!dest_ptr) [[unlikely]] {
         return;
@@ -1341,8 +1360,9 @@ SurfaceId RasterizerCache<T>::CreateSurface(const SurfaceParams& params) {
         return surface_id;
     }();
     Surface& surface = slot_surfaces[surface_id];
+    // A reused surface may be a render target, which needs its attachments at the requested scale.
     if (params.res_scale > surface.res_scale) {
-        surface.ScaleUp(params.res_scale);
+        surface.ScaleUp(params.res_scale, true);
     }
     surface.MarkInvalid(surface.GetInterval());
     return surface_id;
@@ -39,6 +39,13 @@ public:
     /// Draw the current batch of triangles
     virtual void DrawTriangles() = 0;
 
+    /// Records any triangles whose draw was deferred to be merged with the following draws.
+    /// Called before the draw state changes and when a command list ends.
+    virtual void FlushDrawBatch() {}
+
+    /// Drops the triangles whose draw was deferred without drawing them.
+    virtual void DiscardDrawBatch() {}
+
     /// Notify rasterizer that the specified PICA register has been changed
     virtual void NotifyPicaRegisterChanged(u32 id) = 0;
 
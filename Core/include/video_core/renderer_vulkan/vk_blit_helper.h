@@ -7,6 +7,8 @@
 #include "video_core/renderer_vulkan/vk_resource_pool.h"
 
 namespace VideoCore {
+class SurfaceParams;
+struct StagingData;
 struct TextureBlit;
 struct TextureCopy;
 struct BufferTextureCopy;
@@ -35,6 +37,14 @@ public:
     bool DepthToBuffer(Surface& source, vk::Buffer buffer,
                        const VideoCore::BufferTextureCopy& copy);
 
+    /// Returns true if the tiled texture described by params can be decoded on the GPU.
+    bool CanDecodeTexture(const VideoCore::SurfaceParams& params) const;
+
+    /// Detiles and decodes the raw guest texture in src into the linear layout of the CPU decoder
+    /// in dst. Both ranges live in buffer.
+    void DecodeTexture(const VideoCore::SurfaceParams& params, bool converted, vk::Buffer buffer,
+                       const VideoCore::StagingData& src, const VideoCore::StagingData& dst);
+
 private:
     vk::Pipeline MakeComputePipeline(vk::ShaderModule shader, vk::PipelineLayout layout);
     vk::Pipeline MakeDepthStencilBlitPipeline();
@@ -51,18 +61,22 @@ private:
     DescriptorHeap compute_provider;
     DescriptorHeap compute_buffer_provider;
     DescriptorHeap two_textures_provider;
+    DescriptorHeap texture_decode_provider;
     vk::PipelineLayout compute_pipeline_layout;
     vk::PipelineLayout compute_buffer_pipeline_layout;
     vk::PipelineLayout two_textures_pipeline_layout;
+    vk::PipelineLayout texture_decode_pipeline_layout;
 
     vk::ShaderModule full_screen_vert;
     vk::ShaderModule d24s8_to_rgba8_comp;
     vk::ShaderModule depth_to_buffer_comp;
     vk::ShaderModule blit_depth_stencil_frag;
+    vk::ShaderModule texture_decode_comp;
 
     vk::Pipeline d24s8_to_rgba8_pipeline;
     vk::Pipeline depth_to_buffer_pipeline;
     vk::Pipeline depth_blit_pipeline;
+    vk::Pipeline texture_decode_pipeline;
     vk::Sampler linear_sampler;
     vk::Sampler nearest_sampler;
 };
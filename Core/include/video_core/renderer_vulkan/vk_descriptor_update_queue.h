@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <memory>
+#include <utility>
 #include <variant>
 
 #include "common/common_types.h"
@@ -29,6 +30,11 @@ public:
 
     void Flush();
 
+    /// Returns the number of vkUpdateDescriptorSets calls since the last call and resets it.
+    u32 ConsumeUpdateCount() noexcept {
+        return std::exchange(update_count, 0);
+    }
+
     void AddStorageImage(vk::DescriptorSet target, u8 binding, vk::ImageView image_view,
                          vk::ImageLayout image_layout = vk::ImageLayout::eGeneral);
 
@@ -48,6 +54,7 @@ private:
     std::unique_ptr<DescriptorInfoUnion[]> descriptor_infos;
     std::unique_ptr<vk::WriteDescriptorSet[]> descriptor_writes;
     u32 descriptor_write_end = 0;
+    u32 update_count = 0;
 };
 
 } // namespace Vulkan
@@ -2,7 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
-#include "common/thread_worker.h"
+#include "common/task_scheduler.h"
 #include "video_core/pica/regs_pipeline.h"
 #include "video_core/pica/regs_rasterizer.h"
 #include "video_core/rasterizer_cache/pixel_format.h"
@@ -168,7 +168,7 @@ public:
     explicit GraphicsPipeline(const Instance& instance, RenderManager& renderpass_cache,
                               const PipelineInfo& info, vk::PipelineCache pipeline_cache,
                               vk::PipelineLayout layout, std::array<Shader*, 3> stages,
-                              Common::ThreadWorker* worker);
+                              Common::TaskGroup* worker);
     ~GraphicsPipeline();
 
     bool TryBuild(bool wait_built);
@@ -182,7 +182,7 @@ public:
 private:
     const Instance& instance;
     RenderManager& renderpass_cache;
-    Common::ThreadWorker* worker;
+    Common::TaskGroup* worker;
 
     vk::UniquePipeline pipeline;
     vk::PipelineLayout pipeline_layout;
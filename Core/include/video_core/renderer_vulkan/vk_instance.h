@@ -172,6 +172,11 @@ public:
         return external_memory_host;
     }
 
+    /// Returns true when VK_KHR_push_descriptor is supported
+    bool IsPushDescriptorSupported() const {
+        return push_descriptor;
+    }
+
     /// Returns true when VK_KHR_fragment_shader_barycentric is supported
     bool IsFragmentShaderBarycentricSupported() const {
         return fragment_shader_barycentric;
@@ -227,6 +232,16 @@ public:
         return properties.limits.minUniformBufferOffsetAlignment;
     }
 
+    /// Returns the minimum required alignment for storage buffers
+    vk::DeviceSize StorageMinAlignment() const {
+        return properties.limits.minStorageBufferOffsetAlignment;
+    }
+
+    /// Returns the maximum number of workgroups in the x dimension of a compute dispatch
+    u32 MaxComputeWorkGroupCountX() const {
+        return properties.limits.maxComputeWorkGroupCount[0];
+    }
+
     /// Returns the minimum alignemt required for accessing host-mapped device memory
     vk::DeviceSize NonCoherentAtomSize() const {
         return properties.limits.nonCoherentAtomSize;
@@ -326,6 +341,7 @@ private:
     bool fragment_shader_barycentric{};
     bool shader_stencil_export{};
     bool external_memory_host{};
+    bool push_descriptor{};
     u64 min_imported_host_pointer_alignment{};
     bool tooling_info{};
     bool debug_utils_supported{};
@@ -4,9 +4,15 @@
 
 #pragma once
 
+#include <algorithm>
 #include <bitset>
+#include <span>
+#include <unordered_map>
 #include <tsl/robin_map.h>
 
+#include "common/assert.h"
+#include "common/hash.h"
+
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_resource_pool.h"
 #include "video_core/shader/generator/pica_fs_config.h"
@@ -31,6 +37,68 @@ enum class DescriptorHeapType : u32 {
     Utility,
 };
 
+/**
+ * Contents of the texture descriptor set. Draws with equal contents can share a descriptor set.
+ */
+struct TextureDescriptors {
+    static constexpr u32 MaxWrites = 8;
+
+    struct Write {
+        vk::ImageView image_view;
+        vk::Sampler sampler;
+        u8 binding;
+        u8 array_index;
+
+        bool operator==(const Write&) const = default;
+    };
+
+    void Add(u8 binding, u8 array_index, vk::ImageView image_view, vk::Sampler sampler) {
+        ASSERT(num_writes < MaxWrites);
+        writes[num_writes++] = {image_view, sampler, binding, array_index};
+    }
+
+    std::span<const Write> Writes() const noexcept {
+        return {writes.data(), num_writes};
+    }
+
+    u64 Hash() const noexcept {
+        u64 hash = num_writes;
+        for (const Write& write : Writes()) {
+            hash = Common::HashCombine(hash, std::hash<VkImageView>{}(write.image_view));
+            hash = Common::HashCombine(hash, std::hash<VkSampler>{}(write.sampler));
+            hash = Common::HashCombine(hash, (write.binding << 8) | write.array_index);
+        }
+        return hash;
+    }
+
+    bool operator==(const TextureDescriptors& other) const noexcept {
+        return std::ranges::equal(Writes(), other.Writes());
+    }
+
+    std::array<Write, MaxWrites> writes{};
+    u32 num_writes{};
+};
+
+/// Descriptor set counters of the texture heap.
+struct DescriptorStats {
+    u64 sets_written;
+    u64 sets_reused;
+    u64 sets_pushed;
+};
+
+} // namespace Vulkan
+
+namespace std {
+template <>
+struct hash<Vulkan::TextureDescriptors> {
+    std::size_t operator()(const Vulkan::TextureDescriptors& k) const noexcept {
+        return k.Hash();
+    }
+};
+} // namespace std
+
+namespace Vulkan {
+
 /**
  * Stores a collection of rasterizer pipelines used during rendering.
  */
@@ -52,6 +120,18 @@ public:
         return descriptor_set;
     }
 
+    /**
+     * Binds a texture descriptor set with the provided contents. A set written earlier in the
+     * current command buffer is reused when the contents match, and the contents are pushed with
+     * the draw instead when VK_KHR_push_descriptor is supported.
+     */
+    void BindTextures(const TextureDescriptors& textures);
+
+    /// Returns the descriptor set counters since the last call and resets them.
+    DescriptorStats ConsumeStats() noexcept {
+        return std::exchange(stats, {});
+    }
+
     /// Sets the dynamic offset for the uniform buffer at binding
     void UpdateRange(u8 binding, u32 offset) {
         offsets[binding] = offset;
@@ -104,8 +184,7 @@ private:
     Pica::Shader::Profile profile{};
     vk::UniquePipelineCache pipeline_cache;
     vk::UniquePipelineLayout pipeline_layout;
-    std::size_t num_worker_threads;
-    Common::ThreadWorker workers;
+    Common::TaskGroup workers;
     PipelineInfo current_info{};
     GraphicsPipeline* current_pipeline{};
     tsl::robin_map<u64, std::unique_ptr<GraphicsPipeline>, Common::IdentityHash<u64>>
@@ -114,6 +193,12 @@ private:
     std::array<DescriptorHeap, NumDescriptorHeaps> descriptor_heaps;
     std::array<vk::DescriptorSet, NumRasterizerSets> bound_descriptor_sets{};
     std::array<u32, NumDynamicOffsets> offsets{};
+    std::unordered_map<TextureDescriptors, vk::DescriptorSet> texture_sets;
+    u64 texture_sets_tick{};
+    vk::UniqueDescriptorSetLayout texture_push_layout;
+    TextureDescriptors pushed_textures{};
+    bool use_push_descriptors{};
+    DescriptorStats stats{};
 
     std::array<u64, MAX_SHADER_STAGES> shader_hashes;
     std::array<Shader*, MAX_SHADER_STAGES> current_shaders;
@@ -49,6 +49,8 @@ public:
                            const VideoCore::DiskResourceLoadCallback& callback) override;
 
     void DrawTriangles() override;
+    void FlushDrawBatch() override;
+    void DiscardDrawBatch() override;
     void FlushAll() override;
     void FlushRegion(PAddr addr, u32 size) override;
     void InvalidateRegion(PAddr addr, u32 size) override;
@@ -108,11 +110,11 @@ private:
 
     /// Binds the PICA shadow cube required for shadow mapping
     void BindShadowCube(const Pica::TexturingRegs::FullTextureConfig& texture,
-                        vk::DescriptorSet texture_set);
+                        TextureDescriptors& textures);
 
     /// Binds a texture cube to texture unit 0
     void BindTextureCube(const Pica::TexturingRegs::FullTextureConfig& texture,
-                         vk::DescriptorSet texture_set);
+                         TextureDescriptors& textures);
 
     /// Upload the uniform blocks to the uniform buffer object
     void UploadUniforms(bool accelerate_draw);
@@ -168,6 +170,9 @@ private:
     u32 uniform_size_aligned_vs_pica;
     u32 uniform_size_aligned_vs;
     u32 uniform_size_aligned_fs;
+    std::size_t pending_vertices{}; ///< Vertices of the batch whose draw was deferred
+    u32 num_draws_submitted{};      ///< Draws triggered by the guest this frame
+    u32 num_draws_recorded{};       ///< Draws recorded to the command buffer this frame
     bool async_shaders{false};
 };
 
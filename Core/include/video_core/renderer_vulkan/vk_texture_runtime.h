@@ -6,6 +6,7 @@
 
 #include <deque>
 #include <span>
+#include <utility>
 #include "video_core/rasterizer_cache/framebuffer_base.h"
 #include "video_core/rasterizer_cache/rasterizer_cache_base.h"
 #include "video_core/rasterizer_cache/surface_base.h"
@@ -32,6 +33,33 @@ struct Handle {
     vk::UniqueImageView image_view;
 };
 
+/// Creation parameters of an upscaled surface image, used to bucket the recycled images.
+struct ScaledImageKey {
+    u32 width;
+    u32 height;
+    u32 levels;
+    VideoCore::TextureType type;
+    vk::Format format;
+    vk::ImageUsageFlags usage;
+    vk::ImageCreateFlags flags;
+    vk::ImageAspectFlags aspect;
+    bool need_format_list;
+
+    /// Returns the approximate memory footprint of the image.
+    [[nodiscard]] u64 SizeBytes() const noexcept;
+
+    bool operator==(const ScaledImageKey&) const noexcept = default;
+};
+
+/// Counters of the upscaled surface images.
+struct ScaleStats {
+    u64 images_allocated;
+    u64 images_reused;
+    u64 scales_rejected;
+    u64 blits;
+    u64 bytes_allocated;
+};
+
 /**
  * Provides texture manipulation functions to the rasterizer cache
  * Separating this into a class makes it easier to abstract graphics API code
@@ -66,6 +94,14 @@ public:
     /// Maps an internal staging buffer of the provided size for pixel uploads/downloads
     VideoCore::StagingData FindStaging(u32 size, bool upload);
 
+    /// Returns true if the texture described by params should be decoded on the GPU.
+    bool CanDecodeOnGpu(const VideoCore::SurfaceParams& params) const;
+
+    /// Uploads the raw guest texture data and decodes it on the GPU. Returns the staging data
+    /// holding the decoded pixels for Surface::Upload.
+    VideoCore::StagingData DecodeOnGpu(const VideoCore::SurfaceParams& params,
+                                       std::span<const u8> source, u32 decoded_size);
+
     /// Attempts to reinterpret a rectangle of source to another rectangle of dest
     bool Reinterpret(Surface& source, Surface& dest, const VideoCore::TextureCopy& copy);
 
@@ -89,10 +125,50 @@ public:
     /// Returns true if the provided pixel format needs convertion
     bool NeedsConversion(VideoCore::PixelFormat format) const;
 
+    /// Returns the upscaling counters since the last call and resets them.
+    ScaleStats ConsumeScaleStats() noexcept {
+        return std::exchange(scale_stats, ScaleStats{});
+    }
+
 private:
     /// Clears a partial texture rect using a clear rectangle
     void ClearTextureWithRenderpass(Surface& surface, const VideoCore::TextureClear& clear);
 
+    /// Evicts recycled images until an image of size bytes fits the upscaling budget.
+    /// Returns false if the live upscaled images alone exceed it.
+    bool ReserveScaledMemory(u64 size);
+
+    /// Returns a recycled upscaled image matching key, otherwise allocates a new one. When
+    /// enforce_budget is set and the image does not fit the budget an empty handle is returned.
+    Handle AcquireScaledHandle(const ScaledImageKey& key, std::string_view debug_name,
+                               bool enforce_budget);
+
+    /// Returns the upscaled image of a surface to the pool. The image may be reused once the
+    /// GPU has reached tick.
+    void RecycleScaledHandle(const ScaledImageKey& key, Handle&& handle, u64 tick);
+
+    /// Destroys the oldest recycled image.
+    void EvictScaledHandle();
+
+    struct RetiredResources {
+        u64 tick;
+        std::array<vk::UniqueImageView, 3> views;
+        vk::UniqueFramebuffer framebuffer;
+        Handle handle;
+    };
+
+    /// Destroys the views, framebuffer and image of a surface once the GPU has reached their tick.
+    void RetireResources(RetiredResources&& resources);
+
+    /// Destroys the retired resources the GPU has finished with.
+    void ReleaseRetiredResources();
+
+    struct PooledImage {
+        ScaledImageKey key;
+        Handle handle;
+        u64 tick;
+    };
+
 private:
     const Instance& instance;
     Scheduler& scheduler;
@@ -100,6 +176,10 @@ private:
     BlitHelper blit_helper;
     StreamBuffer upload_buffer;
     StreamBuffer download_buffer;
+    std::deque<PooledImage> scaled_pool;
+    std::deque<RetiredResources> retired_resources;
+    u64 scaled_bytes{};
+    ScaleStats scale_stats{};
     u32 num_swapchain_images;
 };
 
@@ -156,8 +236,13 @@ public:
     void Download(const VideoCore::BufferTextureCopy& download,
                   const VideoCore::StagingData& staging);
 
-    /// Scales up the surface to match the new resolution scale.
-    void ScaleUp(u32 new_scale);
+    /// Scales up the surface to match the new resolution scale. Only the base level is scaled
+    /// immediately, the mip levels are scaled by ScaleLevels when first accessed. Unless force is
+    /// set the surface keeps its current scale when the image does not fit the budget.
+    void ScaleUp(u32 new_scale, bool force = false);
+
+    /// Scales the pending mip levels in [level, level + count) of the upscaled image.
+    void ScaleLevels(u32 level = 0, u32 count = 32);
 
     /// Returns the bpp of the internal surface format
     u32 GetInternalBytesPerPixel() const;
@@ -172,6 +257,9 @@ private:
     /// Performs blit between the scaled/unscaled images
     void BlitScale(const VideoCore::TextureBlit& blit, bool up_scale);
 
+    /// Returns the creation parameters of the upscaled image at the current scale.
+    ScaledImageKey MakeScaledKey() const noexcept;
+
     /// Downloads scaled depth stencil data
     void DepthStencilDownload(const VideoCore::BufferTextureCopy& download,
                               const VideoCore::StagingData& staging);
@@ -187,6 +275,8 @@ public:
     vk::UniqueImageView depth_view;
     vk::UniqueImageView stencil_view;
     vk::UniqueImageView storage_view;
+    u32 pending_levels{};
+    bool is_scaled_pooled{};
     bool is_framebuffer{};
     bool is_storage{};
 };
@@ -125,6 +125,52 @@ private:
     udp::endpoint receive_endpoint;
 };
 
+void DeviceStatus::Publish(const Snapshot& new_snapshot) {
+    // Seqlock write: readers that observe an odd or changed sequence retry their copy.
+    const u32 seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    snapshot = new_snapshot;
+    sequence.store(seq + 2, std::memory_order_release);
+}
+
+DeviceStatus::Snapshot DeviceStatus::Read() const {
+    Snapshot result;
+    u32 seq_before;
+    u32 seq_after;
+    do {
+        seq_before = sequence.load(std::memory_order_acquire);
+        result = snapshot;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        seq_after = sequence.load(std::memory_order_relaxed);
+    } while ((seq_before & 1) != 0 || seq_before != seq_after);
+    return result;
+}
+
+std::tuple<Common::Vec3<float>, Common::Vec3<float>> DeviceStatus::GetMotionStatus(
+    Clock::time_point now) const {
+    // Sample pairs further apart than this come from a stalled stream and are not interpolated.
+    constexpr auto MaxSamplePeriod = std::chrono::milliseconds{100};
+
+    const Snapshot current = Read();
+    const MotionSample& latest = current.motion;
+    const MotionSample& previous = current.previous_motion;
+    const auto period = latest.timestamp - previous.timestamp;
+    if (period <= Clock::duration::zero() || period > MaxSamplePeriod || now <= latest.timestamp) {
+        return {latest.accel, latest.gyro};
+    }
+
+    const float t = std::min(std::chrono::duration<float>(now - latest.timestamp) /
+                                 std::chrono::duration<float>(period),
+                             1.0f);
+    return {latest.accel + (latest.accel - previous.accel) * t,
+            latest.gyro + (latest.gyro - previous.gyro) * t};
+}
+
+std::tuple<float, float, bool> DeviceStatus::GetTouchStatus() const {
+    return Read().touch_status;
+}
+
 static void SocketLoop(Socket* socket) {
     socket->StartReceive();
     socket->StartSend(Socket::clock::now());
@@ -157,6 +203,7 @@ void Client::OnPortInfo(Response::PortInfo data) {
 }
 
 void Client::OnPadData(Response::PadData data) {
+    const auto received_at = DeviceStatus::Clock::now();
     LOG_TRACE(Input, "PadData packet received");
     if (data.packet_counter <= packet_sequence) {
         LOG_WARNING(
@@ -171,19 +218,34 @@ void Client::OnPadData(Response::PadData data) {
     // https://github.com/cytrus-emu/cytrus/pull/4049 for more details on gyro/accel
     Common::Vec3f accel = Common::MakeVec<float>(-data.accel.x, data.accel.y, -data.accel.z);
     Common::Vec3f gyro = Common::MakeVec<float>(-data.gyro.pitch, -data.gyro.yaw, data.gyro.roll);
-    {
-        std::lock_guard guard(status->update_mutex);
 
-        status->motion_status = {accel, gyro};
+    // Place the sample on the host timeline using the server's measurement timestamp. The smallest
+    // observed receive delay is taken as the clock offset, so network jitter does not show up as
+    // motion jitter.
+    auto measured_at = received_at;
+    if (data.motion_timestamp != 0) {
+        const auto server_time =
+            std::chrono::microseconds{static_cast<u64>(data.motion_timestamp)};
+        const auto offset = received_at.time_since_epoch() - server_time;
+        if (!timestamp_offset || offset < *timestamp_offset) {
+            timestamp_offset = offset;
+        }
+        measured_at = DeviceStatus::Clock::time_point{server_time + *timestamp_offset};
+    }
 
-        // TODO: add a setting for "click" touch. Click touch refers to a device that differentiates
-        // between a simple "tap" and a hard press that causes the touch screen to click.
-        const bool is_active = data.touch_1.is_active != 0;
+    current_snapshot.previous_motion = current_snapshot.motion;
+    current_snapshot.motion = {measured_at, accel, gyro};
 
-        float x = 0;
-        float y = 0;
+    // TODO: add a setting for "click" touch. Click touch refers to a device that differentiates
+    // between a simple "tap" and a hard press that causes the touch screen to click.
+    const bool is_active = data.touch_1.is_active != 0;
 
-        if (is_active && status->touch_calibration) {
+    float x = 0;
+    float y = 0;
+
+    if (is_active) {
+        std::lock_guard guard(status->calibration_mutex);
+        if (status->touch_calibration) {
             const u16 min_x = status->touch_calibration->min_x;
             const u16 max_x = status->touch_calibration->max_x;
             const u16 min_y = status->touch_calibration->min_y;
@@ -194,12 +256,15 @@ void Client::OnPadData(Response::PadData data) {
             y = (std::clamp(static_cast<u16>(data.touch_1.y), min_y, max_y) - min_y) /
                 static_cast<float>(max_y - min_y);
         }
-
-        status->touch_status = {x, y, is_active};
     }
+
+    current_snapshot.touch_status = {x, y, is_active};
+    status->Publish(current_snapshot);
 }
 
 void Client::StartCommunication(const std::string& host, u16 port, u8 pad_index, u32 client_id) {
+    // A different server may use a different clock for its motion timestamps.
+    timestamp_offset.reset();
     SocketCallback callback{[this](Response::Version version) { OnVersion(version); },
                             [this](Response::PortInfo info) { OnPortInfo(info); },
                             [this](Response::PadData data) { OnPadData(data); }};
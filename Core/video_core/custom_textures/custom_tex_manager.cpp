@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
 #include <json.hpp>
 #include "common/file_util.h"
 #include "common/literals.h"
@@ -52,10 +53,25 @@ MapType MakeMapType(std::string_view ext) {
     return MapType::Color;
 }
 
+u64 GetMemoryBudget() {
+    const u32 budget_mib = Settings::values.custom_textures_budget.GetValue();
+    if (budget_mib != 0) {
+        return static_cast<u64>(budget_mib) * 1_MiB;
+    }
+
+    const u64 sys_mem = Common::GetMemInfo().total_physical_memory;
+    const u64 recommended_min_mem = 2_GiB;
+
+    // keep 2GiB memory for system stability if system RAM is 4GiB+ - use half of memory in other
+    // cases
+    return (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
+}
+
 } // Anonymous namespace
 
 CustomTexManager::CustomTexManager(Core::System& system_)
     : system{system_}, image_interface{*system.GetImageInterface()},
+      memory_budget{GetMemoryBudget()},
       async_custom_loading{Settings::values.async_custom_loading.GetValue()} {}
 
 CustomTexManager::~CustomTexManager() = default;
@@ -73,6 +89,7 @@ void CustomTexManager::TickFrame() {
         switch (it->material->state) {
         case DecodeState::Decoded:
             it->func();
+            MakeResident(it->material);
             num_uploads++;
             [[fallthrough]];
         case DecodeState::Failed:
@@ -97,6 +114,7 @@ void CustomTexManager::FindCustomTextures() {
     const auto textures = GetTextures(title_id);
     if (!ReadConfig(title_id)) {
         use_new_hash = false;
+        use_fast_hash = false;
         skip_mipmap = true;
     }
 
@@ -179,6 +197,7 @@ void CustomTexManager::PrepareDumping(u64 title_id) {
         fmt::format("{}textures/{:016X}/", GetUserPath(FileUtil::UserPath::LoadDir), title_id);
     if (FileUtil::Exists(load_path) && !ReadConfig(title_id, true)) {
         use_new_hash = false;
+        use_fast_hash = false;
     }
 
     // Write template config file
@@ -198,6 +217,7 @@ void CustomTexManager::PrepareDumping(u64 title_id) {
     options["skip_mipmap"] = false;
     options["flip_png_files"] = true;
     options["use_new_hash"] = true;
+    options["use_fast_hash"] = use_fast_hash;
 
     FileUtil::IOFile file{pack_config, "w"};
     const std::string output = json.dump(4);
@@ -206,34 +226,60 @@ void CustomTexManager::PrepareDumping(u64 title_id) {
 
 void CustomTexManager::PreloadTextures(const std::atomic_bool& stop_run,
                                        const VideoCore::DiskResourceLoadCallback& callback) {
-    u64 size_sum = 0;
-    std::size_t preloaded = 0;
-    const u64 sys_mem = Common::GetMemInfo().total_physical_memory;
-    const u64 recommended_min_mem = 2_GiB;
-
-    // keep 2GiB memory for system stability if system RAM is 4GiB+ - use half of memory in other
-    // cases
-    const u64 max_mem =
-        (sys_mem / 2 < recommended_min_mem) ? (sys_mem / 2) : (sys_mem - recommended_min_mem);
-
-    workers->QueueWork([&]() {
-        for (auto& [hash, material] : material_map) {
-            if (size_sum > max_mem) {
-                LOG_WARNING(Render, "Aborting texture preload due to insufficient memory");
-                return;
-            }
-            if (stop_run) {
+    std::atomic<u64> size_sum{stats.bytes_resident};
+    std::atomic<std::size_t> preloaded{};
+    std::atomic_bool out_of_memory{false};
+
+    // Every material is decoded by its own task so the whole scheduler can work on the pack.
+    Common::TaskGroup preload_workers{"Custom texture preload",
+                                      Common::TaskScheduler::Instance().NumWorkers()};
+    for (auto& [hash, material] : material_map) {
+        preload_workers.QueueWork([&, material = material.get()] {
+            if (stop_run || out_of_memory) {
                 return;
             }
             material->LoadFromDisk(flip_png_files);
-            size_sum += material->size;
-            if (callback) {
-                callback(VideoCore::LoadCallbackStage::Preload, preloaded, custom_textures.size());
+            const u64 size = material->size;
+            u64 used = size_sum.load(std::memory_order_relaxed);
+            bool fits;
+            do {
+                fits = used + size <= memory_budget;
+            } while (fits && !size_sum.compare_exchange_weak(used, used + size,
+                                                             std::memory_order_relaxed));
+            if (!fits) {
+                out_of_memory = true;
+                // Maps shared with other materials may already be in use, keep those around.
+                if (!material->IsShared()) {
+                    material->Unload();
+                    return;
+                }
+                size_sum.fetch_add(size, std::memory_order_relaxed);
             }
-            preloaded++;
+            preloaded.fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    // Report progress from this thread at a fixed rate instead of once per material.
+    constexpr std::chrono::milliseconds ProgressInterval{50};
+    const auto report = [&] {
+        if (callback) {
+            callback(VideoCore::LoadCallbackStage::Preload, preloaded.load(), material_map.size());
         }
-    });
-    workers->WaitForRequests();
+    };
+    while (!preload_workers.WaitFor(ProgressInterval)) {
+        report();
+    }
+    report();
+
+    for (auto& [hash, material] : material_map) {
+        MakeResident(material.get());
+    }
+
+    // Materials that did not fit are streamed in on demand.
+    if (out_of_memory) {
+        LOG_WARNING(Render, "Aborting texture preload due to insufficient memory");
+        return;
+    }
     async_custom_loading = false;
 }
 
@@ -292,13 +338,25 @@ Material* CustomTexManager::GetMaterial(u64 data_hash) {
         LOG_WARNING(Render, "Unable to find replacement for surface with hash {:016X}", data_hash);
         return nullptr;
     }
-    return it->second.get();
+    Material* const material = it->second.get();
+    if (material->IsDecoded()) {
+        stats.hits++;
+        if (material->resident) {
+            resident_materials.splice(resident_materials.begin(), resident_materials,
+                                      material->resident_entry);
+        }
+    } else {
+        stats.misses++;
+    }
+    return material;
 }
 
 bool CustomTexManager::Decode(Material* material, std::function<bool()>&& upload) {
     if (!async_custom_loading) {
         material->LoadFromDisk(flip_png_files);
-        return upload();
+        const bool uploaded = upload();
+        MakeResident(material);
+        return uploaded;
     }
     if (material->IsUnloaded()) {
         material->state = DecodeState::Pending;
@@ -336,6 +394,8 @@ bool CustomTexManager::ReadConfig(u64 title_id, bool options_only) {
     skip_mipmap = options["skip_mipmap"].get<bool>();
     flip_png_files = options["flip_png_files"].get<bool>();
     use_new_hash = options["use_new_hash"].get<bool>();
+    // Older packs do not have this option and are keyed on CityHash64.
+    use_fast_hash = options.value("use_fast_hash", false);
 
     if (options_only) {
         return true;
@@ -386,7 +446,76 @@ std::vector<FileUtil::FSTEntry> CustomTexManager::GetTextures(u64 title_id) {
 
 void CustomTexManager::CreateWorkers() {
     const std::size_t num_workers = std::max(std::thread::hardware_concurrency(), 2U) >> 1;
-    workers = std::make_unique<Common::ThreadWorker>(num_workers, "Custom textures");
+    workers = std::make_unique<Common::TaskGroup>("Custom textures", num_workers);
+}
+
+void CustomTexManager::MakeResident(Material* material) {
+    if (!material->IsDecoded()) {
+        return;
+    }
+    if (material->resident) {
+        resident_materials.splice(resident_materials.begin(), resident_materials,
+                                  material->resident_entry);
+        return;
+    }
+    material->resident_entry = resident_materials.insert(resident_materials.begin(), material);
+    material->resident = true;
+    stats.bytes_resident += material->size;
+    EvictToBudget();
+}
+
+void CustomTexManager::EvictToBudget() {
+    if (stats.bytes_resident <= memory_budget) {
+        return;
+    }
+    // Evicting a material may evict the materials sharing its maps as well, so walk a snapshot.
+    const std::vector<Material*> candidates(resident_materials.rbegin(), resident_materials.rend());
+    std::vector<Material*> group;
+    for (Material* const candidate : candidates) {
+        if (stats.bytes_resident <= memory_budget) {
+            return;
+        }
+        if (!candidate->resident || !CollectEvictionGroup(candidate, group)) {
+            continue;
+        }
+        for (Material* const material : group) {
+            if (material->resident) {
+                resident_materials.erase(material->resident_entry);
+                material->resident = false;
+                stats.bytes_resident -= material->size;
+                stats.evictions++;
+            }
+            material->Unload();
+        }
+    }
+}
+
+bool CustomTexManager::CollectEvictionGroup(Material* material, std::vector<Material*>& group) {
+    const auto is_upload_queued = [this](const Material* queued) {
+        return std::ranges::any_of(async_uploads, [queued](const AsyncUpload& upload) {
+            return upload.material == queued;
+        });
+    };
+    group.assign(1, material);
+    for (std::size_t i = 0; i < group.size(); i++) {
+        Material* const member = group[i];
+        if (member->IsPending() || is_upload_queued(member)) {
+            return false;
+        }
+        for (const CustomTexture* texture : member->textures) {
+            if (!texture || texture->hashes.size() < 2) {
+                continue;
+            }
+            for (const u64 hash : texture->hashes) {
+                const auto it = material_map.find(hash);
+                if (it != material_map.end() &&
+                    std::ranges::find(group, it->second.get()) == group.end()) {
+                    group.push_back(it->second.get());
+                }
+            }
+        }
+    }
+    return true;
 }
 
 } // namespace VideoCore
@@ -54,17 +54,17 @@ CustomTexture::CustomTexture(Frontend::ImageInterface& image_interface_)
 
 CustomTexture::~CustomTexture() = default;
 
-void CustomTexture::LoadFromDisk(bool flip_png) {
+bool CustomTexture::LoadFromDisk(bool flip_png) {
     std::scoped_lock lock{decode_mutex};
     if (IsLoaded()) {
-        return;
+        return false;
     }
 
     FileUtil::IOFile file{path, "rb"};
     std::vector<u8> input(file.GetSize());
     if (file.ReadBytes(input.data(), input.size()) != input.size()) {
         LOG_CRITICAL(Render, "Failed to open custom texture: {}", path);
-        return;
+        return false;
     }
     switch (file_format) {
     case CustomFileFormat::PNG:
@@ -77,6 +77,12 @@ void CustomTexture::LoadFromDisk(bool flip_png) {
     default:
         LOG_ERROR(Render, "Unknown file format {}", file_format);
     }
+    return IsLoaded();
+}
+
+void CustomTexture::Unload() {
+    std::scoped_lock lock{decode_mutex};
+    std::vector<u8>().swap(data);
 }
 
 void CustomTexture::LoadPNG(std::span<const u8> input, bool flip_png) {
@@ -100,13 +106,14 @@ void Material::LoadFromDisk(bool flip_png) noexcept {
     if (IsDecoded()) {
         return;
     }
+    // Maps may be shared with other materials that are decoded concurrently, only count the
+    // bytes of the maps decoded here.
     for (CustomTexture* const texture : textures) {
-        if (!texture || texture->IsLoaded()) {
+        if (!texture || !texture->LoadFromDisk(flip_png)) {
             continue;
         }
-        texture->LoadFromDisk(flip_png);
         size += texture->data.size();
-        LOG_DEBUG(Render, "Loading {} map {}", MapTypeName(texture->type), texture->path);
+        LOG_DEBUG(Render, "Loaded {} map {}", MapTypeName(texture->type), texture->path);
     }
     if (!textures[0]) {
         LOG_ERROR(Render, "Unable to create material without color texture!");
@@ -141,6 +148,16 @@ void Material::LoadFromDisk(bool flip_png) noexcept {
     state = DecodeState::Decoded;
 }
 
+void Material::Unload() noexcept {
+    for (CustomTexture* const texture : textures) {
+        if (texture) {
+            texture->Unload();
+        }
+    }
+    size = 0;
+    state = DecodeState::None;
+}
+
 void Material::AddMapTexture(CustomTexture* texture) noexcept {
     const std::size_t index = static_cast<std::size_t>(texture->type);
     if (textures[index]) {
@@ -2,8 +2,12 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <array>
+#include <mutex>
+#include <vector>
 #include "common/archives.h"
 #include "common/microprofile.h"
+#include "common/settings.h"
 #include "core/core.h"
 #include "core/core_timing.h"
 #include "core/hle/service/gsp/gsp_gpu.h"
@@ -11,6 +15,7 @@
 #include "video_core/debug_utils/debug_utils.h"
 #include "video_core/gpu.h"
 #include "video_core/gpu_debugger.h"
+#include "video_core/gpu_thread.h"
 #include "video_core/pica/pica_core.h"
 #include "video_core/pica/regs_lcd.h"
 #include "video_core/renderer_base.h"
@@ -36,15 +41,28 @@ struct GPU::Impl {
     RasterizerInterface* rasterizer;
     std::unique_ptr<SwRenderer::SwBlitter> sw_blitter;
     Core::TimingEventType* vblank_event;
+    Core::TimingEventType* interrupt_event;
     Service::GSP::InterruptHandler signal_interrupt;
 
+    // Interrupts raised on the GPU thread, waiting to be delivered on the emulation thread.
+    std::mutex interrupt_mutex;
+    std::vector<Service::GSP::InterruptId> pending_interrupts;
+
+    // Fence of the last buffer swap, the emulation thread keeps at most one frame ahead of it.
+    u64 swap_fence{};
+    std::unique_ptr<GPUThread> gpu_thread;
+
     explicit Impl(Core::System& system, Frontend::EmuWindow& emu_window,
                   Frontend::EmuWindow* secondary_window)
         : timing{system.CoreTiming()}, system{system}, memory{system.Memory()},
           debug_context{Pica::g_debug_context}, pica{memory, debug_context},
           renderer{VideoCore::CreateRenderer(emu_window, secondary_window, pica, system)},
           rasterizer{renderer->Rasterizer()},
-          sw_blitter{std::make_unique<SwRenderer::SwBlitter>(memory, rasterizer)} {}
+          sw_blitter{std::make_unique<SwRenderer::SwBlitter>(memory, rasterizer)} {
+        if (Settings::values.async_gpu_emulation.GetValue()) {
+            gpu_thread = std::make_unique<GPUThread>();
+        }
+    }
     ~Impl() = default;
 };
 
@@ -55,12 +73,19 @@ GPU::GPU(Core::System& system, Frontend::EmuWindow& emu_window,
         "GPU::VBlankCallback",
         [this](uintptr_t user_data, s64 cycles_late) { VBlankCallback(user_data, cycles_late); });
     impl->timing.ScheduleEvent(FRAME_TICKS, impl->vblank_event);
+    impl->interrupt_event = impl->timing.RegisterEvent(
+        "GPU::InterruptCallback", [this](uintptr_t, s64) { DeliverInterrupts(); });
 
     // Bind the rasterizer to the PICA GPU
     impl->pica.BindRasterizer(impl->rasterizer);
 }
 
-GPU::~GPU() = default;
+GPU::~GPU() {
+    // Finish the queued work while the state it refers to is still alive.
+    impl->gpu_thread.reset();
+    impl->timing.UnscheduleEvent(impl->interrupt_event, 0);
+    impl->pending_interrupts.clear();
+}
 
 PAddr GPU::VirtualToPhysicalAddress(VAddr addr) {
     if (addr == 0) {
@@ -89,24 +114,35 @@ PAddr GPU::VirtualToPhysicalAddress(VAddr addr) {
 
 void GPU::SetInterruptHandler(Service::GSP::InterruptHandler handler) {
     impl->signal_interrupt = handler;
-    impl->pica.SetInterruptHandler(handler);
+    if (impl->gpu_thread) {
+        Service::GSP::InterruptHandler deferred_handler =
+            [this](Service::GSP::InterruptId interrupt_id) { SignalInterrupt(interrupt_id); };
+        impl->pica.SetInterruptHandler(deferred_handler);
+    } else {
+        impl->pica.SetInterruptHandler(handler);
+    }
 }
 
 void GPU::FlushRegion(PAddr addr, u32 size) {
+    impl->memory.RasterizerCommitWrites();
+    WaitIdle();
     impl->rasterizer->FlushRegion(addr, size);
 }
 
 void GPU::InvalidateRegion(PAddr addr, u32 size) {
+    impl->memory.RasterizerCommitWrites();
+    WaitIdle();
     impl->rasterizer->InvalidateRegion(addr, size);
 }
 
 void GPU::ClearAll(bool flush) {
+    impl->memory.RasterizerCommitWrites();
+    WaitIdle();
     impl->rasterizer->ClearAll(flush);
 }
 
 void GPU::Execute(const Service::GSP::Command& command) {
     using Service::GSP::CommandId;
-    auto& regs = impl->pica.regs;
 
     switch (command.id) {
     case CommandId::RequestDma: {
@@ -125,70 +161,90 @@ void GPU::Execute(const Service::GSP::Command& command) {
         break;
     }
     case CommandId::SubmitCmdList: {
-        auto& params = command.submit_gpu_cmdlist;
-        auto& cmdbuffer = regs.internal.pipeline.command_buffer;
+        const auto params = command.submit_gpu_cmdlist;
+        const PAddr address = VirtualToPhysicalAddress(params.address);
 
-        // Write to the command buffer GPU registers
-        cmdbuffer.addr[0].Assign(VirtualToPhysicalAddress(params.address) >> 3);
-        cmdbuffer.size[0].Assign(params.size >> 3);
-        cmdbuffer.trigger[0] = 1;
+        Dispatch([this, params, address] {
+            auto& cmdbuffer = impl->pica.regs.internal.pipeline.command_buffer;
 
-        // Trigger processing of the command list
-        SubmitCmdList(0);
+            // Write to the command buffer GPU registers
+            cmdbuffer.addr[0].Assign(address >> 3);
+            cmdbuffer.size[0].Assign(params.size >> 3);
+            cmdbuffer.trigger[0] = 1;
+
+            // Trigger processing of the command list
+            SubmitCmdList(0);
+        });
         break;
     }
     case CommandId::MemoryFill: {
-        auto& params = command.memory_fill;
-        auto& memfill = regs.memory_fill_config;
-
-        // Write to the memory fill GPU registers.
-        if (params.start1 != 0) {
-            memfill[0].address_start = VirtualToPhysicalAddress(params.start1) >> 3;
-            memfill[0].address_end = VirtualToPhysicalAddress(params.end1) >> 3;
-            memfill[0].value_32bit = params.value1;
-            memfill[0].control = params.control1;
-            MemoryFill(0);
-        }
-        if (params.start2 != 0) {
-            memfill[1].address_start = VirtualToPhysicalAddress(params.start2) >> 3;
-            memfill[1].address_end = VirtualToPhysicalAddress(params.end2) >> 3;
-            memfill[1].value_32bit = params.value2;
-            memfill[1].control = params.control2;
-            MemoryFill(1);
-        }
+        const auto params = command.memory_fill;
+        const std::array<PAddr, 4> addresses{
+            VirtualToPhysicalAddress(params.start1), VirtualToPhysicalAddress(params.end1),
+            VirtualToPhysicalAddress(params.start2), VirtualToPhysicalAddress(params.end2)};
+
+        Dispatch([this, params, addresses] {
+            auto& memfill = impl->pica.regs.memory_fill_config;
+
+            // Write to the memory fill GPU registers.
+            if (params.start1 != 0) {
+                memfill[0].address_start = addresses[0] >> 3;
+                memfill[0].address_end = addresses[1] >> 3;
+                memfill[0].value_32bit = params.value1;
+                memfill[0].control = params.control1;
+                MemoryFill(0);
+            }
+            if (params.start2 != 0) {
+                memfill[1].address_start = addresses[2] >> 3;
+                memfill[1].address_end = addresses[3] >> 3;
+                memfill[1].value_32bit = params.value2;
+                memfill[1].control = params.control2;
+                MemoryFill(1);
+            }
+        });
         break;
     }
     case CommandId::DisplayTransfer: {
-        auto& params = command.display_transfer;
-        auto& display_transfer = regs.display_transfer_config;
-
-        // Write to the transfer engine GPU registers.
-        display_transfer.input_address = VirtualToPhysicalAddress(params.in_buffer_address) >> 3;
-        display_transfer.output_address = VirtualToPhysicalAddress(params.out_buffer_address) >> 3;
-        display_transfer.input_size = params.in_buffer_size;
-        display_transfer.output_size = params.out_buffer_size;
-        display_transfer.flags = params.flags;
-        display_transfer.trigger.Assign(1);
-
-        // Trigger the display transfer.
-        MemoryTransfer();
+        const auto params = command.display_transfer;
+        const PAddr input_address = VirtualToPhysicalAddress(params.in_buffer_address);
+        const PAddr output_address = VirtualToPhysicalAddress(params.out_buffer_address);
+
+        Dispatch([this, params, input_address, output_address] {
+            auto& display_transfer = impl->pica.regs.display_transfer_config;
+
+            // Write to the transfer engine GPU registers.
+            display_transfer.input_address = input_address >> 3;
+            display_transfer.output_address = output_address >> 3;
+            display_transfer.input_size = params.in_buffer_size;
+            display_transfer.output_size = params.out_buffer_size;
+            display_transfer.flags = params.flags;
+            display_transfer.trigger.Assign(1);
+
+            // Trigger the display transfer.
+            MemoryTransfer();
+        });
         break;
     }
     case CommandId::TextureCopy: {
-        auto& params = command.texture_copy;
-        auto& texture_copy = regs.display_transfer_config;
-
-        // Write to the transfer engine GPU registers.
-        texture_copy.input_address = VirtualToPhysicalAddress(params.in_buffer_address) >> 3;
-        texture_copy.output_address = VirtualToPhysicalAddress(params.out_buffer_address) >> 3;
-        texture_copy.texture_copy.size = params.size;
-        texture_copy.texture_copy.input_size = params.in_width_gap;
-        texture_copy.texture_copy.output_size = params.out_width_gap;
-        texture_copy.flags = params.flags;
-        texture_copy.trigger.Assign(1);
-
-        // Trigger the texture copy.
-        MemoryTransfer();
+        const auto params = command.texture_copy;
+        const PAddr input_address = VirtualToPhysicalAddress(params.in_buffer_address);
+        const PAddr output_address = VirtualToPhysicalAddress(params.out_buffer_address);
+
+        Dispatch([this, params, input_address, output_address] {
+            auto& texture_copy = impl->pica.regs.display_transfer_config;
+
+            // Write to the transfer engine GPU registers.
+            texture_copy.input_address = input_address >> 3;
+            texture_copy.output_address = output_address >> 3;
+            texture_copy.texture_copy.size = params.size;
+            texture_copy.texture_copy.input_size = params.in_width_gap;
+            texture_copy.texture_copy.output_size = params.out_width_gap;
+            texture_copy.flags = params.flags;
+            texture_copy.trigger.Assign(1);
+
+            // Trigger the texture copy.
+            MemoryTransfer();
+        });
         break;
     }
     case CommandId::CacheFlush: {
@@ -210,19 +266,21 @@ void GPU::SetBufferSwap(u32 screen_id, const Service::GSP::FrameBufferInfo& info
     const PAddr phys_address_left = VirtualToPhysicalAddress(info.address_left);
     const PAddr phys_address_right = VirtualToPhysicalAddress(info.address_right);
 
-    // Update framebuffer properties.
-    auto& framebuffer = impl->pica.regs.framebuffer_config[screen_id];
-    if (info.active_fb == 0) {
-        framebuffer.address_left1 = phys_address_left;
-        framebuffer.address_right1 = phys_address_right;
-    } else {
-        framebuffer.address_left2 = phys_address_left;
-        framebuffer.address_right2 = phys_address_right;
-    }
+    Dispatch([this, screen_id, info, phys_address_left, phys_address_right] {
+        // Update framebuffer properties.
+        auto& framebuffer = impl->pica.regs.framebuffer_config[screen_id];
+        if (info.active_fb == 0) {
+            framebuffer.address_left1 = phys_address_left;
+            framebuffer.address_right1 = phys_address_right;
+        } else {
+            framebuffer.address_left2 = phys_address_left;
+            framebuffer.address_right2 = phys_address_right;
+        }
 
-    framebuffer.stride = info.stride;
-    framebuffer.format = info.format;
-    framebuffer.active_fb = info.shown_fb;
+        framebuffer.stride = info.stride;
+        framebuffer.format = info.format;
+        framebuffer.active_fb = info.shown_fb;
+    });
 
     // Notify debugger about the buffer swap.
     if (impl->debug_context) {
@@ -236,11 +294,14 @@ void GPU::SetBufferSwap(u32 screen_id, const Service::GSP::FrameBufferInfo& info
 }
 
 void GPU::SetColorFill(const Pica::ColorFill& fill) {
-    impl->pica.regs_lcd.color_fill_top = fill;
-    impl->pica.regs_lcd.color_fill_bottom = fill;
+    Dispatch([this, fill] {
+        impl->pica.regs_lcd.color_fill_top = fill;
+        impl->pica.regs_lcd.color_fill_bottom = fill;
+    });
 }
 
 u32 GPU::ReadReg(VAddr addr) {
+    WaitIdle();
     switch (addr & 0xFFFFF000) {
     case VADDR_LCD: {
         const u32 offset = addr - VADDR_LCD;
@@ -263,55 +324,70 @@ u32 GPU::ReadReg(VAddr addr) {
 }
 
 void GPU::WriteReg(VAddr addr, u32 data) {
-    switch (addr & 0xFFFFF000) {
-    case VADDR_LCD: {
-        const u32 offset = addr - VADDR_LCD;
-        const u32 index = offset / sizeof(u32);
-        ASSERT(addr % sizeof(u32) == 0);
-        ASSERT(index < Pica::RegsLcd::NumIds());
-        impl->pica.regs_lcd[index] = data;
-        break;
-    }
-    case VADDR_GPU:
-    case VADDR_GPU + 0x1000: {
-        const u32 offset = addr - VADDR_GPU;
-        const u32 index = offset / sizeof(u32);
-
-        ASSERT(addr % sizeof(u32) == 0);
-        ASSERT(index < Pica::PicaCore::Regs::NUM_REGS);
-        impl->pica.regs.reg_array[index] = data;
-
-        // Handle registers that trigger GPU actions
-        switch (index) {
-        case GPU_REG_INDEX(memory_fill_config[0].trigger):
-            MemoryFill(0);
-            break;
-        case GPU_REG_INDEX(memory_fill_config[1].trigger):
-            MemoryFill(1);
+    Dispatch([this, addr, data] {
+        switch (addr & 0xFFFFF000) {
+        case VADDR_LCD: {
+            const u32 offset = addr - VADDR_LCD;
+            const u32 index = offset / sizeof(u32);
+            ASSERT(addr % sizeof(u32) == 0);
+            ASSERT(index < Pica::RegsLcd::NumIds());
+            impl->pica.regs_lcd[index] = data;
             break;
-        case GPU_REG_INDEX(display_transfer_config.trigger):
-            MemoryTransfer();
-            break;
-        case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[0]):
-            SubmitCmdList(0);
-            break;
-        case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[1]):
-            SubmitCmdList(1);
+        }
+        case VADDR_GPU:
+        case VADDR_GPU + 0x1000: {
+            const u32 offset = addr - VADDR_GPU;
+            const u32 index = offset / sizeof(u32);
+
+            ASSERT(addr % sizeof(u32) == 0);
+            ASSERT(index < Pica::PicaCore::Regs::NUM_REGS);
+            impl->pica.regs.reg_array[index] = data;
+
+            // Handle registers that trigger GPU actions
+            switch (index) {
+            case GPU_REG_INDEX(memory_fill_config[0].trigger):
+                MemoryFill(0);
+                break;
+            case GPU_REG_INDEX(memory_fill_config[1].trigger):
+                MemoryFill(1);
+                break;
+            case GPU_REG_INDEX(display_transfer_config.trigger):
+                MemoryTransfer();
+                break;
+            case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[0]):
+                SubmitCmdList(0);
+                break;
+            case GPU_REG_INDEX(internal.pipeline.command_buffer.trigger[1]):
+                SubmitCmdList(1);
+                break;
+            default:
+                break;
+            }
             break;
+        }
         default:
-            break;
+            UNREACHABLE_MSG("Write to unknown GPU address {:#08X}", addr);
         }
-        break;
-    }
-    default:
-        UNREACHABLE_MSG("Write to unknown GPU address {:#08X}", addr);
-    }
+    });
 }
 
 void GPU::Sync() {
+    WaitIdle();
     impl->renderer->Sync();
 }
 
+void GPU::WaitIdle() {
+    if (impl->gpu_thread && !impl->gpu_thread->IsGPUThread()) {
+        impl->gpu_thread->WaitIdle();
+        impl->memory.RasterizerApplyCacheMarks();
+    }
+}
+
+void GPU::Synchronize() {
+    WaitIdle();
+    DeliverInterrupts();
+}
+
 VideoCore::RendererBase& GPU::Renderer() {
     return *impl->renderer;
 }
@@ -332,6 +408,47 @@ GraphicsDebugger& GPU::Debugger() {
     return impl->gpu_debugger;
 }
 
+u64 GPU::Dispatch(Common::UniqueFunction<void> work) {
+    impl->memory.RasterizerApplyCacheMarks();
+    impl->memory.RasterizerCommitWrites();
+    if (!impl->gpu_thread) {
+        work();
+        return 0;
+    }
+    return impl->gpu_thread->Submit(std::move(work));
+}
+
+void GPU::SignalInterrupt(Service::GSP::InterruptId interrupt_id) {
+    if (!impl->gpu_thread || !impl->gpu_thread->IsGPUThread()) {
+        impl->signal_interrupt(interrupt_id);
+        return;
+    }
+
+    bool schedule;
+    {
+        std::scoped_lock lock{impl->interrupt_mutex};
+        schedule = impl->pending_interrupts.empty();
+        impl->pending_interrupts.push_back(interrupt_id);
+    }
+    if (schedule) {
+        impl->timing.ScheduleEvent(0, impl->interrupt_event, 0, 0, true);
+    }
+}
+
+void GPU::DeliverInterrupts() {
+    // Writes made after the guest sees the interrupt must reach the surfaces the GPU created.
+    impl->memory.RasterizerApplyCacheMarks();
+
+    std::vector<Service::GSP::InterruptId> interrupts;
+    {
+        std::scoped_lock lock{impl->interrupt_mutex};
+        interrupts.swap(impl->pending_interrupts);
+    }
+    for (const auto interrupt_id : interrupts) {
+        impl->signal_interrupt(interrupt_id);
+    }
+}
+
 void GPU::SubmitCmdList(u32 index) {
     // Check if a command list was triggered.
     auto& config = impl->pica.regs.internal.pipeline.command_buffer;
@@ -364,9 +481,9 @@ void GPU::MemoryFill(u32 index) {
     // TODO: hwtest this
     if (config.GetStartAddress() != 0) {
         if (!index) {
-            impl->signal_interrupt(Service::GSP::InterruptId::PSC0);
+            SignalInterrupt(Service::GSP::InterruptId::PSC0);
         } else {
-            impl->signal_interrupt(Service::GSP::InterruptId::PSC1);
+            SignalInterrupt(Service::GSP::InterruptId::PSC1);
         }
     }
 
@@ -403,12 +520,18 @@ void GPU::MemoryTransfer() {
 
     // Complete transfer.
     config.trigger.Assign(0);
-    impl->signal_interrupt(Service::GSP::InterruptId::PPF);
+    SignalInterrupt(Service::GSP::InterruptId::PPF);
 }
 
 void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
-    // Present renderered frame.
-    impl->renderer->SwapBuffers();
+    // Present renderered frame. The GPU thread runs the frame limiter while presenting, so waiting
+    // for the previous frame keeps emulation from running more than a frame ahead of it.
+    const u64 previous_swap_fence = impl->swap_fence;
+    impl->swap_fence = Dispatch([this] { impl->renderer->SwapBuffers(); });
+    if (impl->gpu_thread) {
+        impl->gpu_thread->WaitForFence(previous_swap_fence);
+        impl->memory.RasterizerApplyCacheMarks();
+    }
 
     // Signal to GSP that GPU interrupt has occurred
     impl->signal_interrupt(Service::GSP::InterruptId::PDC0);
@@ -421,6 +544,11 @@ void GPU::VBlankCallback(std::uintptr_t user_data, s64 cycles_late) {
 template <class Archive>
 void GPU::serialize(Archive& ar, const u32 file_version) {
     ar & impl->pica;
+    if (Archive::is_loading::value) {
+        // Interrupts raised before the load belong to the discarded state.
+        std::scoped_lock lock{impl->interrupt_mutex};
+        impl->pending_interrupts.clear();
+    }
 }
 
 SERIALIZE_IMPL(GPU)
@@ -0,0 +1,71 @@
+// Copyright 2024 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include "common/thread.h"
+#include "video_core/gpu_thread.h"
+
+namespace VideoCore {
+
+namespace {
+thread_local bool is_gpu_thread = false;
+} // Anonymous namespace
+
+GPUThread::GPUThread() : thread{[this](std::stop_token stop_token) { ThreadLoop(stop_token); }} {}
+
+GPUThread::~GPUThread() {
+    // The submitted work may be the only copy of guest state, e.g. a pending display transfer.
+    WaitIdle();
+}
+
+u64 GPUThread::Submit(Common::UniqueFunction<void> work) {
+    u64 fence;
+    {
+        std::scoped_lock lock{mutex};
+        queue.push_back(std::move(work));
+        fence = submitted_fence.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    work_cv.notify_one();
+    return fence;
+}
+
+void GPUThread::WaitForFence(u64 fence) {
+    if (completed_fence.load(std::memory_order_acquire) >= fence || IsGPUThread()) {
+        return;
+    }
+    std::unique_lock lock{mutex};
+    fence_cv.wait(lock, [&] { return completed_fence.load(std::memory_order_relaxed) >= fence; });
+}
+
+void GPUThread::WaitIdle() {
+    WaitForFence(submitted_fence.load(std::memory_order_relaxed));
+}
+
+bool GPUThread::IsGPUThread() {
+    return is_gpu_thread;
+}
+
+void GPUThread::ThreadLoop(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("GPU");
+    is_gpu_thread = true;
+    while (!stop_token.stop_requested()) {
+        Common::UniqueFunction<void> work;
+        {
+            std::unique_lock lock{mutex};
+            Common::CondvarWait(work_cv, lock, stop_token, [this] { return !queue.empty(); });
+            if (stop_token.stop_requested()) {
+                return;
+            }
+            work = std::move(queue.front());
+            queue.pop_front();
+        }
+        work();
+        {
+            std::scoped_lock lock{mutex};
+            completed_fence.fetch_add(1, std::memory_order_release);
+        }
+        fence_cv.notify_all();
+    }
+}
+
+} // namespace VideoCore
@@ -30,6 +30,13 @@ union CommandHeader {
 };
 static_assert(sizeof(CommandHeader) == sizeof(u32), "CommandHeader has incorrect size!");
 
+static constexpr bool IsLutDataReg(u32 id) {
+    const auto in_port = [id](u32 first) { return id >= first && id < first + 8; };
+    return in_port(PICA_REG_INDEX(lighting.lut_data[0])) ||
+           in_port(PICA_REG_INDEX(texturing.fog_lut_data[0])) ||
+           in_port(PICA_REG_INDEX(texturing.proctex_lut_data[0]));
+}
+
 PicaCore::PicaCore(Memory::MemorySystem& memory_, std::shared_ptr<DebugContext> debug_context_)
     : memory{memory_}, debug_context{std::move(debug_context_)},
       geometry_pipeline{regs.internal, gs_unit, gs_setup},
@@ -116,6 +123,10 @@ void PicaCore::ProcessCmdList(PAddr list, u32 size) {
             WriteInternalReg(cmd, extra_value, header.parameter_mask);
         }
     }
+
+    // Draws are only merged within a command list. The guest may change the memory of the
+    // surfaces they use once the list is done, so they must be looked up now.
+    rasterizer->FlushDrawBatch();
 }
 
 void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
@@ -137,7 +148,15 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
     // TODO: Figure out how register masking acts on e.g. vs.uniform_setup.set_value
     const u32 old_value = regs.internal.reg_array[id];
     const u32 write_mask = ExpandBitsToBytes[mask];
-    regs.internal.reg_array[id] = (old_value & ~write_mask) | (value & write_mask);
+    const u32 new_value = (old_value & ~write_mask) | (value & write_mask);
+
+    // The registers before the pipeline block hold the state used to draw the triangles batched
+    // by the rasterizer, so they must be drawn before it changes. Writes to the LUT data ports
+    // always change a LUT entry, even when the register value itself stays the same.
+    if (id < PICA_REG_INDEX(pipeline) && (new_value != old_value || IsLutDataReg(id))) {
+        rasterizer->FlushDrawBatch();
+    }
+    regs.internal.reg_array[id] = new_value;
 
     // Track register write.
     DebugUtils::OnPicaRegWrite(id, mask, regs.internal.reg_array[id]);
@@ -232,8 +251,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= 4096) {
             LOG_ERROR(HW_GPU, "Invalid GS program offset {}", offset);
         } else {
-            gs_setup.program_code[offset] = value;
-            gs_setup.MarkProgramCodeDirty();
+            gs_setup.WriteProgramCode(offset, value);
             offset++;
         }
         break;
@@ -251,8 +269,7 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= gs_setup.swizzle_data.size()) {
             LOG_ERROR(HW_GPU, "Invalid GS swizzle pattern offset {}", offset);
         } else {
-            gs_setup.swizzle_data[offset] = value;
-            gs_setup.MarkSwizzleDataDirty();
+            gs_setup.WriteSwizzleData(offset, value);
             offset++;
         }
         break;
@@ -314,11 +331,9 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= 512) {
             LOG_ERROR(HW_GPU, "Invalid VS program offset {}", offset);
         } else {
-            vs_setup.program_code[offset] = value;
-            vs_setup.MarkProgramCodeDirty();
+            vs_setup.WriteProgramCode(offset, value);
             if (!regs.internal.pipeline.gs_unit_exclusive_configuration) {
-                gs_setup.program_code[offset] = value;
-                gs_setup.MarkProgramCodeDirty();
+                gs_setup.WriteProgramCode(offset, value);
             }
             offset++;
         }
@@ -337,11 +352,9 @@ void PicaCore::WriteInternalReg(u32 id, u32 value, u32 mask) {
         if (offset >= vs_setup.swizzle_data.size()) {
             LOG_ERROR(HW_GPU, "Invalid VS swizzle pattern offset {}", offset);
         } else {
-            vs_setup.swizzle_data[offset] = value;
-            vs_setup.MarkSwizzleDataDirty();
+            vs_setup.WriteSwizzleData(offset, value);
             if (!regs.internal.pipeline.gs_unit_exclusive_configuration) {
-                gs_setup.swizzle_data[offset] = value;
-                gs_setup.MarkSwizzleDataDirty();
+                gs_setup.WriteSwizzleData(offset, value);
             }
             offset++;
         }
@@ -46,9 +46,51 @@ std::optional<u32> ShaderSetup::WriteUniformFloatReg(ShaderRegs& config, u32 val
     return index;
 }
 
+u64 ShaderMemoryHash::Get(const std::array<u32, MAX_PROGRAM_CODE_LENGTH>& data) {
+    const u64 used_mask =
+        num_used_blocks == NumBlocks ? ~u64{0} : (u64{1} << num_used_blocks) - 1;
+    if ((dirty_blocks & used_mask) == 0) {
+        return hash;
+    }
+
+    constexpr std::size_t block_size = BlockWords * sizeof(u32);
+    for (u32 block = 0; block < num_used_blocks; ++block) {
+        if (dirty_blocks & (u64{1} << block)) {
+            block_hashes[block] = Common::ComputeHash64(&data[block * BlockWords], block_size);
+        }
+    }
+    dirty_blocks &= ~used_mask;
+
+    hash = num_used_blocks;
+    for (u32 block = 0; block < num_used_blocks; ++block) {
+        hash = Common::HashCombine(hash, block_hashes[block]);
+    }
+    return hash;
+}
+
+void ShaderSetup::WriteProgramCode(u32 offset, u32 value) {
+    // Games often upload the same program every frame, rewriting a word with its own value
+    // leaves the hash intact.
+    if (program_code[offset] == value) {
+        return;
+    }
+    program_code[offset] = value;
+    program_code_blocks.MarkDirty(offset);
+    program_code_hash_dirty = true;
+}
+
+void ShaderSetup::WriteSwizzleData(u32 offset, u32 value) {
+    if (swizzle_data[offset] == value) {
+        return;
+    }
+    swizzle_data[offset] = value;
+    swizzle_data_blocks.MarkDirty(offset);
+    swizzle_data_hash_dirty = true;
+}
+
 u64 ShaderSetup::GetProgramCodeHash() {
     if (program_code_hash_dirty) {
-        program_code_hash = Common::ComputeHash64(&program_code, sizeof(program_code));
+        program_code_hash = program_code_blocks.Get(program_code);
         program_code_hash_dirty = false;
     }
     return program_code_hash;
@@ -56,7 +98,7 @@ u64 ShaderSetup::GetProgramCodeHash() {
 
 u64 ShaderSetup::GetSwizzleDataHash() {
     if (swizzle_data_hash_dirty) {
-        swizzle_data_hash = Common::ComputeHash64(&swizzle_data, sizeof(swizzle_data));
+        swizzle_data_hash = swizzle_data_blocks.Get(swizzle_data);
         swizzle_data_hash_dirty = false;
     }
     return swizzle_data_hash;
@@ -164,6 +164,10 @@ RasterizerAccelerated::VertexArrayInfo RasterizerAccelerated::AnalyzeVertexArray
 }
 
 void RasterizerAccelerated::SyncEntireState() {
+    // The state is replaced wholesale when a savestate is loaded, the triangles of the previous
+    // state must not be drawn with it.
+    DiscardDrawBatch();
+
     // Sync renderer-specific fixed-function state
     SyncFixedState();
 
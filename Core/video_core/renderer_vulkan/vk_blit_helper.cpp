@@ -2,7 +2,10 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include "common/alignment.h"
 #include "common/vector_math.h"
+#include "video_core/rasterizer_cache/surface_params.h"
+#include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_vulkan/vk_blit_helper.h"
 #include "video_core/renderer_vulkan/vk_descriptor_update_queue.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -15,6 +18,7 @@
 #include "video_core/host_shaders/full_screen_triangle_vert.h"
 #include "video_core/host_shaders/vulkan_blit_depth_stencil_frag.h"
 #include "video_core/host_shaders/vulkan_depth_to_buffer_comp.h"
+#include "video_core/host_shaders/vulkan_texture_decode_comp.h"
 
 namespace Vulkan {
 
@@ -32,6 +36,19 @@ struct ComputeInfo {
     Common::Vec2i src_extent;
 };
 
+struct TextureDecodeInfo {
+    u32 format;
+    u32 width;
+    u32 height;
+    u32 bits_per_pixel;
+    u32 linear_bytes_per_pixel;
+    u32 raw;
+};
+static_assert(sizeof(TextureDecodeInfo) <= sizeof(ComputeInfo));
+
+/// Number of linear buffer words written by one texture decode workgroup.
+constexpr u32 TEXTURE_DECODE_GROUP_SIZE = 64;
+
 inline constexpr vk::PushConstantRange COMPUTE_PUSH_CONSTANT_RANGE{
     .stageFlags = vk::ShaderStageFlagBits::eCompute,
     .offset = 0,
@@ -50,6 +67,11 @@ constexpr std::array<vk::DescriptorSetLayoutBinding, 3> COMPUTE_BUFFER_BINDINGS
     {2, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
 }};
 
+constexpr std::array<vk::DescriptorSetLayoutBinding, 2> TEXTURE_DECODE_BINDINGS = {{
+    {0, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+    {1, vk::DescriptorType::eStorageBuffer, 1, vk::ShaderStageFlagBits::eCompute},
+}};
+
 constexpr std::array<vk::DescriptorSetLayoutBinding, 2> TWO_TEXTURES_BINDINGS = {{
     {0, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
     {1, vk::DescriptorType::eCombinedImageSampler, 1, vk::ShaderStageFlagBits::eFragment},
@@ -185,12 +207,16 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_,
       compute_provider{instance, scheduler.GetMasterSemaphore(), COMPUTE_BINDINGS},
       compute_buffer_provider{instance, scheduler.GetMasterSemaphore(), COMPUTE_BUFFER_BINDINGS},
       two_textures_provider{instance, scheduler.GetMasterSemaphore(), TWO_TEXTURES_BINDINGS, 16},
+      texture_decode_provider{instance, scheduler.GetMasterSemaphore(), TEXTURE_DECODE_BINDINGS,
+                              16},
       compute_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&compute_provider.Layout(), true))},
       compute_buffer_pipeline_layout{device.createPipelineLayout(
           PipelineLayoutCreateInfo(&compute_buffer_provider.Layout(), true))},
       two_textures_pipeline_layout{
           device.createPipelineLayout(PipelineLayoutCreateInfo(&two_textures_provider.Layout()))},
+      texture_decode_pipeline_layout{device.createPipelineLayout(
+          PipelineLayoutCreateInfo(&texture_decode_provider.Layout(), true))},
       full_screen_vert{Compile(HostShaders::FULL_SCREEN_TRIANGLE_VERT,
                                vk::ShaderStageFlagBits::eVertex, device)},
       d24s8_to_rgba8_comp{Compile(HostShaders::VULKAN_D24S8_TO_RGBA8_COMP,
@@ -199,10 +225,14 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_,
                                    vk::ShaderStageFlagBits::eCompute, device)},
       blit_depth_stencil_frag{Compile(HostShaders::VULKAN_BLIT_DEPTH_STENCIL_FRAG,
                                       vk::ShaderStageFlagBits::eFragment, device)},
+      texture_decode_comp{Compile(HostShaders::VULKAN_TEXTURE_DECODE_COMP,
+                                  vk::ShaderStageFlagBits::eCompute, device)},
       d24s8_to_rgba8_pipeline{MakeComputePipeline(d24s8_to_rgba8_comp, compute_pipeline_layout)},
       depth_to_buffer_pipeline{
           MakeComputePipeline(depth_to_buffer_comp, compute_buffer_pipeline_layout)},
       depth_blit_pipeline{MakeDepthStencilBlitPipeline()},
+      texture_decode_pipeline{
+          MakeComputePipeline(texture_decode_comp, texture_decode_pipeline_layout)},
       linear_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eLinear>)},
       nearest_sampler{device.createSampler(SAMPLER_CREATE_INFO<vk::Filter::eNearest>)} {
 
@@ -212,12 +242,16 @@ BlitHelper::BlitHelper(const Instance& instance_, Scheduler& scheduler_,
                       "BlitHelper: compute_buffer_pipeline_layout");
         SetObjectName(device, two_textures_pipeline_layout,
                       "BlitHelper: two_textures_pipeline_layout");
+        SetObjectName(device, texture_decode_pipeline_layout,
+                      "BlitHelper: texture_decode_pipeline_layout");
         SetObjectName(device, full_screen_vert, "BlitHelper: full_screen_vert");
         SetObjectName(device, d24s8_to_rgba8_comp, "BlitHelper: d24s8_to_rgba8_comp");
         SetObjectName(device, depth_to_buffer_comp, "BlitHelper: depth_to_buffer_comp");
         SetObjectName(device, blit_depth_stencil_frag, "BlitHelper: blit_depth_stencil_frag");
+        SetObjectName(device, texture_decode_comp, "BlitHelper: texture_decode_comp");
         SetObjectName(device, d24s8_to_rgba8_pipeline, "BlitHelper: d24s8_to_rgba8_pipeline");
         SetObjectName(device, depth_to_buffer_pipeline, "BlitHelper: depth_to_buffer_pipeline");
+        SetObjectName(device, texture_decode_pipeline, "BlitHelper: texture_decode_pipeline");
         if (depth_blit_pipeline) {
             SetObjectName(device, depth_blit_pipeline, "BlitHelper: depth_blit_pipeline");
         }
@@ -230,13 +264,16 @@ BlitHelper::~BlitHelper() {
     device.destroyPipelineLayout(compute_pipeline_layout);
     device.destroyPipelineLayout(compute_buffer_pipeline_layout);
     device.destroyPipelineLayout(two_textures_pipeline_layout);
+    device.destroyPipelineLayout(texture_decode_pipeline_layout);
     device.destroyShaderModule(full_screen_vert);
     device.destroyShaderModule(d24s8_to_rgba8_comp);
     device.destroyShaderModule(depth_to_buffer_comp);
     device.destroyShaderModule(blit_depth_stencil_frag);
+    device.destroyShaderModule(texture_decode_comp);
     device.destroyPipeline(depth_to_buffer_pipeline);
     device.destroyPipeline(d24s8_to_rgba8_pipeline);
     device.destroyPipeline(depth_blit_pipeline);
+    device.destroyPipeline(texture_decode_pipeline);
     device.destroySampler(linear_sampler);
     device.destroySampler(nearest_sampler);
 }
@@ -498,6 +535,77 @@ bool BlitHelper::DepthToBuffer(Surface& source, vk::Buffer buffer,
     return true;
 }
 
+bool BlitHelper::CanDecodeTexture(const VideoCore::SurfaceParams& params) const {
+    if (!params.is_tiled || params.pixel_format > PixelFormat::ETC1A4) {
+        return false;
+    }
+    const u32 max_words = params.width * params.height;
+    const u32 num_groups = Common::AlignUp(max_words, TEXTURE_DECODE_GROUP_SIZE) /
+                           TEXTURE_DECODE_GROUP_SIZE;
+    return num_groups <= instance.MaxComputeWorkGroupCountX();
+}
+
+void BlitHelper::DecodeTexture(const VideoCore::SurfaceParams& params, bool converted,
+                               vk::Buffer buffer, const VideoCore::StagingData& src,
+                               const VideoCore::StagingData& dst) {
+    const auto descriptor_set = texture_decode_provider.Commit();
+    update_queue.AddBuffer(descriptor_set, 0, buffer, src.offset, Common::AlignUp(src.size, 4),
+                           vk::DescriptorType::eStorageBuffer);
+    update_queue.AddBuffer(descriptor_set, 1, buffer, dst.offset, dst.size,
+                           vk::DescriptorType::eStorageBuffer);
+
+    // The formats after RGBA4 are always expanded to RGBA8, the others are copied unless the
+    // host lacks a matching format.
+    const bool raw = !converted && params.pixel_format <= PixelFormat::RGBA4;
+    const TextureDecodeInfo info = {
+        .format = static_cast<u32>(params.pixel_format),
+        .width = params.width,
+        .height = params.height,
+        .bits_per_pixel = VideoCore::GetFormatBpp(params.pixel_format),
+        .linear_bytes_per_pixel = dst.size / (params.width * params.height),
+        .raw = raw,
+    };
+    const u32 num_groups =
+        Common::AlignUp(dst.size / 4, TEXTURE_DECODE_GROUP_SIZE) / TEXTURE_DECODE_GROUP_SIZE;
+
+    renderpass_cache.EndRendering();
+    scheduler.Record([this, descriptor_set, info, num_groups, buffer,
+                      dst](vk::CommandBuffer cmdbuf) {
+        const vk::BufferMemoryBarrier pre_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferRead,
+            .dstAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = dst.offset,
+            .size = dst.size,
+        };
+        const vk::BufferMemoryBarrier post_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eShaderWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferRead,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .buffer = buffer,
+            .offset = dst.offset,
+            .size = dst.size,
+        };
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                               vk::PipelineStageFlagBits::eComputeShader,
+                               vk::DependencyFlagBits::eByRegion, {}, pre_barrier, {});
+
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eCompute, texture_decode_pipeline_layout,
+                                  0, descriptor_set, {});
+        cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, texture_decode_pipeline);
+        cmdbuf.pushConstants(texture_decode_pipeline_layout, vk::ShaderStageFlagBits::eCompute, 0,
+                             sizeof(info), &info);
+        cmdbuf.dispatch(num_groups, 1, 1);
+
+        cmdbuf.pipelineBarrier(vk::PipelineStageFlagBits::eComputeShader,
+                               vk::PipelineStageFlagBits::eTransfer,
+                               vk::DependencyFlagBits::eByRegion, {}, post_barrier, {});
+    });
+}
+
 vk::Pipeline BlitHelper::MakeComputePipeline(vk::ShaderModule shader, vk::PipelineLayout layout) {
     const vk::ComputePipelineCreateInfo compute_info = {
         .stage = MakeStages(shader),
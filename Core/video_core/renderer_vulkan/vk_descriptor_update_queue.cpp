@@ -19,6 +19,7 @@ void DescriptorUpdateQueue::Flush() {
     }
     device.updateDescriptorSets({std::span(descriptor_writes.get(), descriptor_write_end)}, {});
     descriptor_write_end = 0;
+    update_count++;
 }
 
 void DescriptorUpdateQueue::AddStorageImage(vk::DescriptorSet target, u8 binding,
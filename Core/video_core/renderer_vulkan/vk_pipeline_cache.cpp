@@ -81,12 +81,12 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
                              RenderManager& renderpass_cache_, DescriptorUpdateQueue& update_queue_)
     : instance{instance_}, scheduler{scheduler_}, renderpass_cache{renderpass_cache_},
       update_queue{update_queue_},
-      num_worker_threads{std::max(std::thread::hardware_concurrency(), 2U) >> 1},
-      workers{num_worker_threads, "Pipeline workers"},
+      workers{"Pipeline workers", std::max(std::thread::hardware_concurrency(), 2U) >> 1},
       descriptor_heaps{
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), BUFFER_BINDINGS, 32},
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), TEXTURE_BINDINGS<1>},
           DescriptorHeap{instance, scheduler.GetMasterSemaphore(), UTILITY_BINDINGS, 32}},
+      use_push_descriptors{instance.IsPushDescriptorSupported()},
       trivial_vertex_shader{
           instance, vk::ShaderStageFlagBits::eVertex,
           GLSL::GenerateTrivialVertexShader(instance.IsShaderClipDistanceSupported(), true)} {
@@ -112,6 +112,17 @@ void PipelineCache::BuildLayout() {
     descriptor_set_layouts[1] = descriptor_heaps[1].Layout();
     descriptor_set_layouts[2] = descriptor_heaps[2].Layout();
 
+    // With push descriptors the textures are written into the command buffer with each draw.
+    if (use_push_descriptors) {
+        const vk::DescriptorSetLayoutCreateInfo layout_ci = {
+            .flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+            .bindingCount = static_cast<u32>(TEXTURE_BINDINGS<1>.size()),
+            .pBindings = TEXTURE_BINDINGS<1>.data(),
+        };
+        texture_push_layout = instance.GetDevice().createDescriptorSetLayoutUnique(layout_ci);
+        descriptor_set_layouts[1] = *texture_push_layout;
+    }
+
     const vk::PipelineLayoutCreateInfo layout_info = {
         .setLayoutCount = NumRasterizerSets,
         .pSetLayouts = descriptor_set_layouts.data(),
@@ -125,6 +136,38 @@ PipelineCache::~PipelineCache() {
     SaveDiskCache();
 }
 
+void PipelineCache::BindTextures(const TextureDescriptors& textures) {
+    if (use_push_descriptors) {
+        pushed_textures = textures;
+        ++stats.sets_pushed;
+        return;
+    }
+
+    // Descriptor sets committed during the current tick cannot be recycled by the heap before the
+    // command buffer completes, so their contents stay valid until the next submission.
+    const u64 tick = scheduler.CurrentTick();
+    if (texture_sets_tick != tick) {
+        texture_sets.clear();
+        texture_sets_tick = tick;
+    }
+
+    constexpr u32 index = static_cast<u32>(DescriptorHeapType::Texture);
+    const auto [it, new_set] = texture_sets.try_emplace(textures);
+    if (!new_set) {
+        bound_descriptor_sets[index] = it->second;
+        ++stats.sets_reused;
+        return;
+    }
+
+    const vk::DescriptorSet texture_set = Acquire(DescriptorHeapType::Texture);
+    for (const auto& write : textures.Writes()) {
+        update_queue.AddImageSampler(texture_set, write.binding, write.array_index,
+                                     write.image_view, write.sampler);
+    }
+    it->second = texture_set;
+    ++stats.sets_written;
+}
+
 void PipelineCache::LoadDiskCache() {
     if (!Settings::values.use_disk_shader_cache || !EnsureDirectories()) {
         return;
@@ -220,6 +263,7 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
     scheduler.Record([this, is_dirty, pipeline_dirty, pipeline,
                       current_dynamic = current_info.dynamic, dynamic = info.dynamic,
                       descriptor_sets = bound_descriptor_sets, offsets = offsets,
+                      push_descriptors = use_push_descriptors, textures = pushed_textures,
                       current_rasterization = current_info.rasterization,
                       current_depth_stencil = current_info.depth_stencil,
                       rasterization = info.rasterization,
@@ -321,8 +365,40 @@ bool PipelineCache::BindPipeline(const PipelineInfo& info, bool wait_built) {
             cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->Handle());
         }
 
+        if (!push_descriptors) {
+            cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout, 0,
+                                      descriptor_sets, offsets);
+            return;
+        }
+
+        constexpr u32 texture_index = static_cast<u32>(DescriptorHeapType::Texture);
+        constexpr u32 utility_index = static_cast<u32>(DescriptorHeapType::Utility);
         cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout, 0,
-                                  descriptor_sets, offsets);
+                                  descriptor_sets[0], offsets);
+        cmdbuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, *pipeline_layout,
+                                  utility_index, descriptor_sets[utility_index], {});
+
+        std::array<vk::DescriptorImageInfo, TextureDescriptors::MaxWrites> image_infos;
+        std::array<vk::WriteDescriptorSet, TextureDescriptors::MaxWrites> writes;
+        u32 num_writes = 0;
+        for (const auto& write : textures.Writes()) {
+            image_infos[num_writes] = vk::DescriptorImageInfo{
+                .sampler = write.sampler,
+                .imageView = write.image_view,
+                .imageLayout = vk::ImageLayout::eGeneral,
+            };
+            writes[num_writes] = vk::WriteDescriptorSet{
+                .dstBinding = write.binding,
+                .dstArrayElement = write.array_index,
+                .descriptorCount = 1,
+                .descriptorType = write.sampler ? vk::DescriptorType::eCombinedImageSampler
+                                                : vk::DescriptorType::eSampledImage,
+                .pImageInfo = &image_infos[num_writes],
+            };
+            num_writes++;
+        }
+        cmdbuf.pushDescriptorSetKHR(vk::PipelineBindPoint::eGraphics, *pipeline_layout,
+                                    texture_index, std::span(writes.data(), num_writes));
     });
 
     current_info = info;
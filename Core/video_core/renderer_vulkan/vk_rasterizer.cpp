@@ -34,6 +34,9 @@ constexpr u64 STREAM_BUFFER_SIZE = 64_MiB;
 constexpr u64 UNIFORM_BUFFER_SIZE = 4_MiB;
 constexpr u64 TEXTURE_BUFFER_SIZE = 2_MiB;
 
+// Keeps a merged software draw to a few MiB of the vertex stream buffer.
+constexpr std::size_t MAX_BATCH_VERTICES = 3 * 16384;
+
 constexpr vk::BufferUsageFlags BUFFER_USAGE =
     vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer;
 
@@ -118,15 +121,15 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
     update_queue.AddTexelBuffer(buffer_set, 4, *texture_rg_view);
     update_queue.AddTexelBuffer(buffer_set, 5, *texture_rgba_view);
 
-    const auto texture_set = pipeline_cache.Acquire(DescriptorHeapType::Texture);
     Surface& null_surface = res_cache.GetSurface(VideoCore::NULL_SURFACE_ID);
     Sampler& null_sampler = res_cache.GetSampler(VideoCore::NULL_SAMPLER_ID);
 
     // Prepare texture and utility descriptor sets.
+    TextureDescriptors null_textures{};
     for (u32 i = 0; i < 3; i++) {
-        update_queue.AddImageSampler(texture_set, i, 0, null_surface.ImageView(),
-                                     null_sampler.Handle());
+        null_textures.Add(i, 0, null_surface.ImageView(), null_sampler.Handle());
     }
+    pipeline_cache.BindTextures(null_textures);
 
     const auto utility_set = pipeline_cache.Acquire(DescriptorHeapType::Utility);
     update_queue.AddStorageImage(utility_set, 0, null_surface.StorageView());
@@ -140,7 +143,27 @@ RasterizerVulkan::RasterizerVulkan(Memory::MemorySystem& memory, Pica::PicaCore&
 RasterizerVulkan::~RasterizerVulkan() = default;
 
 void RasterizerVulkan::TickFrame() {
+    FlushDrawBatch();
     res_cache.TickFrame();
+
+    LOG_TRACE(Render_Vulkan, "Frame draws: {} submitted, {} recorded after merging",
+              num_draws_submitted, num_draws_recorded);
+    num_draws_submitted = 0;
+    num_draws_recorded = 0;
+
+    const DescriptorStats stats = pipeline_cache.ConsumeStats();
+    LOG_TRACE(Render_Vulkan,
+              "Frame descriptor updates: {} vkUpdateDescriptorSets calls, {} texture sets written, "
+              "{} reused, {} pushed",
+              update_queue.ConsumeUpdateCount(), stats.sets_written, stats.sets_reused,
+              stats.sets_pushed);
+
+    const ScaleStats scale_stats = runtime.ConsumeScaleStats();
+    LOG_TRACE(Render_Vulkan,
+              "Frame texture scaling: {} images allocated ({} bytes), {} reused, {} rejected by "
+              "the budget, {} blits",
+              scale_stats.images_allocated, scale_stats.bytes_allocated, scale_stats.images_reused,
+              scale_stats.scales_rejected, scale_stats.blits);
 }
 
 void RasterizerVulkan::LoadDiskResources(const std::atomic_bool& stop_loading,
@@ -353,6 +376,8 @@ bool RasterizerVulkan::SetupGeometryShader() {
 }
 
 bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
+    FlushDrawBatch();
+
     if (regs.pipeline.use_gs != Pica::PipelineRegs::UseGS::No) {
         if (regs.pipeline.gs_config.mode != Pica::PipelineRegs::GSMode::Point) {
             return false;
@@ -382,6 +407,7 @@ bool RasterizerVulkan::AccelerateDrawBatch(bool is_indexed) {
         return false;
     }
 
+    num_draws_submitted++;
     return Draw(true, is_indexed);
 }
 
@@ -448,6 +474,20 @@ void RasterizerVulkan::SetupIndexArray() {
 }
 
 void RasterizerVulkan::DrawTriangles() {
+    if (vertex_batch.size() == pending_vertices) {
+        return;
+    }
+    pending_vertices = vertex_batch.size();
+    num_draws_submitted++;
+
+    // The draw state cannot change before the batch is flushed, so the triangles of the following
+    // draws are appended and recorded together with these ones.
+    if (pending_vertices >= MAX_BATCH_VERTICES) {
+        FlushDrawBatch();
+    }
+}
+
+void RasterizerVulkan::FlushDrawBatch() {
     if (vertex_batch.empty()) {
         return;
     }
@@ -459,6 +499,13 @@ void RasterizerVulkan::DrawTriangles() {
     pipeline_cache.UseTrivialGeometryShader();
 
     Draw(false, false);
+    vertex_batch.clear();
+    pending_vertices = 0;
+}
+
+void RasterizerVulkan::DiscardDrawBatch() {
+    vertex_batch.clear();
+    pending_vertices = 0;
 }
 
 bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
@@ -481,6 +528,7 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
     if (!framebuffer->Handle()) {
         return true;
     }
+    num_draws_recorded++;
 
     pipeline_info.attachments.color = framebuffer->Format(SurfaceType::Color);
     pipeline_info.attachments.depth = framebuffer->Format(SurfaceType::Depth);
@@ -556,10 +604,7 @@ void RasterizerVulkan::SyncTextureUnits(const Framebuffer* framebuffer) {
     using TextureType = Pica::TexturingRegs::TextureConfig::TextureType;
 
     const auto pica_textures = regs.texturing.GetTextures();
-    const bool use_cube_heap =
-        pica_textures[0].enabled && pica_textures[0].config.type == TextureType::ShadowCube;
-    const auto texture_set = pipeline_cache.Acquire(use_cube_heap ? DescriptorHeapType::Texture
-                                                                  : DescriptorHeapType::Texture);
+    TextureDescriptors textures{};
 
     for (u32 texture_index = 0; texture_index < pica_textures.size(); ++texture_index) {
         const auto& texture = pica_textures[texture_index];
@@ -568,8 +613,7 @@ void RasterizerVulkan::SyncTextureUnits(const Framebuffer* framebuffer) {
         if (!texture.enabled) {
             const Surface& null_surface = res_cache.GetSurface(VideoCore::NULL_SURFACE_ID);
             const Sampler& null_sampler = res_cache.GetSampler(VideoCore::NULL_SAMPLER_ID);
-            update_queue.AddImageSampler(texture_set, texture_index, 0, null_surface.ImageView(),
-                                         null_sampler.Handle());
+            textures.Add(texture_index, 0, null_surface.ImageView(), null_sampler.Handle());
             continue;
         }
 
@@ -580,16 +624,15 @@ void RasterizerVulkan::SyncTextureUnits(const Framebuffer* framebuffer) {
                 Surface& surface = res_cache.GetTextureSurface(texture);
                 Sampler& sampler = res_cache.GetSampler(texture.config);
                 surface.flags |= VideoCore::SurfaceFlagBits::ShadowMap;
-                update_queue.AddImageSampler(texture_set, texture_index, 0, surface.StorageView(),
-                                             sampler.Handle());
+                textures.Add(texture_index, 0, surface.StorageView(), sampler.Handle());
                 continue;
             }
             case TextureType::ShadowCube: {
-                BindShadowCube(texture, texture_set);
+                BindShadowCube(texture, textures);
                 continue;
             }
             case TextureType::TextureCube: {
-                BindTextureCube(texture, texture_set);
+                BindTextureCube(texture, textures);
                 continue;
             }
             default:
@@ -600,12 +643,15 @@ void RasterizerVulkan::SyncTextureUnits(const Framebuffer* framebuffer) {
         // Bind the texture provided by the rasterizer cache
         Surface& surface = res_cache.GetTextureSurface(texture);
         Sampler& sampler = res_cache.GetSampler(texture.config);
+        surface.ScaleLevels();
         const vk::ImageView color_view = framebuffer->ImageView(SurfaceType::Color);
         const bool is_feedback_loop = color_view == surface.ImageView();
         const vk::ImageView texture_view =
             is_feedback_loop ? surface.CopyImageView() : surface.ImageView();
-        update_queue.AddImageSampler(texture_set, texture_index, 0, texture_view, sampler.Handle());
+        textures.Add(texture_index, 0, texture_view, sampler.Handle());
     }
+
+    pipeline_cache.BindTextures(textures);
 }
 
 void RasterizerVulkan::SyncUtilityTextures(const Framebuffer* framebuffer) {
@@ -619,7 +665,7 @@ void RasterizerVulkan::SyncUtilityTextures(const Framebuffer* framebuffer) {
 }
 
 void RasterizerVulkan::BindShadowCube(const Pica::TexturingRegs::FullTextureConfig& texture,
-                                      vk::DescriptorSet texture_set) {
+                                      TextureDescriptors& textures) {
     using CubeFace = Pica::TexturingRegs::CubeFace;
     auto info = Pica::Texture::TextureInfo::FromPicaRegister(texture.config, texture.format);
     constexpr std::array faces = {
@@ -636,13 +682,12 @@ void RasterizerVulkan::BindShadowCube(const Pica::TexturingRegs::FullTextureConf
         const VideoCore::SurfaceId surface_id = res_cache.GetTextureSurface(info);
         Surface& surface = res_cache.GetSurface(surface_id);
         surface.flags |= VideoCore::SurfaceFlagBits::ShadowMap;
-        update_queue.AddImageSampler(texture_set, 0, binding, surface.StorageView(),
-                                     sampler.Handle());
+        textures.Add(0, binding, surface.StorageView(), sampler.Handle());
     }
 }
 
 void RasterizerVulkan::BindTextureCube(const Pica::TexturingRegs::FullTextureConfig& texture,
-                                       vk::DescriptorSet texture_set) {
+                                       TextureDescriptors& textures) {
     using CubeFace = Pica::TexturingRegs::CubeFace;
     const VideoCore::TextureCubeConfig config = {
         .px = regs.texturing.GetCubePhysicalAddress(CubeFace::PositiveX),
@@ -658,7 +703,8 @@ void RasterizerVulkan::BindTextureCube(const Pica::TexturingRegs::FullTextureCon
 
     Surface& surface = res_cache.GetTextureCube(config);
     Sampler& sampler = res_cache.GetSampler(texture.config);
-    update_queue.AddImageSampler(texture_set, 0, 0, surface.ImageView(), sampler.Handle());
+    surface.ScaleLevels();
+    textures.Add(0, 0, surface.ImageView(), sampler.Handle());
 }
 
 void RasterizerVulkan::NotifyFixedFunctionPicaRegisterChanged(u32 id) {
@@ -724,41 +770,50 @@ void RasterizerVulkan::NotifyFixedFunctionPicaRegisterChanged(u32 id) {
 }
 
 void RasterizerVulkan::FlushAll() {
+    FlushDrawBatch();
     res_cache.FlushAll();
 }
 
 void RasterizerVulkan::FlushRegion(PAddr addr, u32 size) {
+    FlushDrawBatch();
     res_cache.FlushRegion(addr, size);
 }
 
 void RasterizerVulkan::InvalidateRegion(PAddr addr, u32 size) {
+    FlushDrawBatch();
     res_cache.InvalidateRegion(addr, size);
 }
 
 void RasterizerVulkan::FlushAndInvalidateRegion(PAddr addr, u32 size) {
+    FlushDrawBatch();
     res_cache.FlushRegion(addr, size);
     res_cache.InvalidateRegion(addr, size);
 }
 
 void RasterizerVulkan::ClearAll(bool flush) {
+    FlushDrawBatch();
     res_cache.ClearAll(flush);
 }
 
 bool RasterizerVulkan::AccelerateDisplayTransfer(const Pica::DisplayTransferConfig& config) {
+    FlushDrawBatch();
     return res_cache.AccelerateDisplayTransfer(config);
 }
 
 bool RasterizerVulkan::AccelerateTextureCopy(const Pica::DisplayTransferConfig& config) {
+    FlushDrawBatch();
     return res_cache.AccelerateTextureCopy(config);
 }
 
 bool RasterizerVulkan::AccelerateFill(const Pica::MemoryFillConfig& config) {
+    FlushDrawBatch();
     return res_cache.AccelerateFill(config);
 }
 
 bool RasterizerVulkan::AccelerateDisplay(const Pica::FramebufferConfig& config,
                                          PAddr framebuffer_addr, u32 pixel_stride,
                                          ScreenInfo& screen_info) {
+    FlushDrawBatch();
     if (framebuffer_addr == 0) [[unlikely]] {
         return false;
     }
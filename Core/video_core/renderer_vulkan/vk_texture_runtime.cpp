@@ -8,6 +8,7 @@
 #include "common/literals.h"
 #include "common/microprofile.h"
 #include "common/scope_exit.h"
+#include "common/settings.h"
 #include "video_core/custom_textures/material.h"
 #include "video_core/rasterizer_cache/texture_codec.h"
 #include "video_core/rasterizer_cache/utils.h"
@@ -244,23 +245,43 @@ vk::ImageSubresourceRange MakeSubresourceRange(vk::ImageAspectFlags aspect, u32
 
 constexpr u64 UPLOAD_BUFFER_SIZE = 512_MiB;
 constexpr u64 DOWNLOAD_BUFFER_SIZE = 16_MiB;
+constexpr std::size_t MAX_POOLED_SCALED_IMAGES = 64;
 
 } // Anonymous namespace
 
+u64 ScaledImageKey::SizeBytes() const noexcept {
+    const u64 layers = type == TextureType::CubeMap ? 6 : 1;
+    u64 texels = 0;
+    for (u32 level = 0; level < levels; level++) {
+        texels += u64{std::max(width >> level, 1U)} * std::max(height >> level, 1U);
+    }
+    return texels * layers * vk::blockSize(format);
+}
+
 TextureRuntime::TextureRuntime(const Instance& instance, Scheduler& scheduler,
                                RenderManager& renderpass_cache, DescriptorUpdateQueue& update_queue,
                                u32 num_swapchain_images_)
     : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache},
       blit_helper{instance, scheduler, renderpass_cache, update_queue},
-      upload_buffer{instance, scheduler, vk::BufferUsageFlagBits::eTransferSrc, UPLOAD_BUFFER_SIZE,
-                    BufferType::Upload},
+      upload_buffer{instance, scheduler,
+                    vk::BufferUsageFlagBits::eTransferSrc |
+                        vk::BufferUsageFlagBits::eStorageBuffer,
+                    UPLOAD_BUFFER_SIZE, BufferType::Upload},
       download_buffer{instance, scheduler,
                       vk::BufferUsageFlagBits::eTransferDst |
                           vk::BufferUsageFlagBits::eStorageBuffer,
                       DOWNLOAD_BUFFER_SIZE, BufferType::Download},
       num_swapchain_images{num_swapchain_images_} {}
 
-TextureRuntime::~TextureRuntime() = default;
+TextureRuntime::~TextureRuntime() {
+    while (!scaled_pool.empty()) {
+        EvictScaledHandle();
+    }
+    if (!retired_resources.empty()) {
+        scheduler.Wait(retired_resources.back().tick);
+        ReleaseRetiredResources();
+    }
+}
 
 VideoCore::StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
     StreamBuffer& buffer = upload ? upload_buffer : download_buffer;
@@ -272,6 +293,38 @@ VideoCore::StagingData TextureRuntime::FindStaging(u32 size, bool upload) {
     };
 }
 
+bool TextureRuntime::CanDecodeOnGpu(const VideoCore::SurfaceParams& params) const {
+    return Settings::values.gpu_texture_decoding.GetValue() &&
+           blit_helper.CanDecodeTexture(params);
+}
+
+VideoCore::StagingData TextureRuntime::DecodeOnGpu(const VideoCore::SurfaceParams& params,
+                                                   std::span<const u8> source, u32 decoded_size) {
+    const u64 alignment = std::max<u64>(instance.StorageMinAlignment(), 16);
+    const u32 source_size = static_cast<u32>(source.size());
+
+    // The tiled data must be committed before mapping the decoded range after it.
+    const auto [source_data, source_offset, source_invalidate] =
+        upload_buffer.Map(Common::AlignUp(source_size, 4), alignment);
+    std::memcpy(source_data, source.data(), source_size);
+    upload_buffer.Commit(source_size);
+
+    const auto [data, offset, invalidate] = upload_buffer.Map(decoded_size, alignment);
+    const VideoCore::StagingData tiled = {
+        .size = source_size,
+        .offset = source_offset,
+        .mapped = std::span{source_data, source_size},
+    };
+    const VideoCore::StagingData decoded = {
+        .size = decoded_size,
+        .offset = offset,
+        .mapped = std::span{data, decoded_size},
+    };
+    blit_helper.DecodeTexture(params, NeedsConversion(params.pixel_format),
+                              upload_buffer.Handle(), tiled, decoded);
+    return decoded;
+}
+
 u32 TextureRuntime::RemoveThreshold() {
     return num_swapchain_images;
 }
@@ -286,6 +339,9 @@ bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
     const PixelFormat dst_format = dest.pixel_format;
     ASSERT_MSG(src_format != dst_format, "Reinterpretation with the same format is invalid");
 
+    source.ScaleLevels(copy.src_level, 1);
+    dest.ScaleLevels(copy.dst_level, 1);
+
     if (!source.traits.needs_conversion && !dest.traits.needs_conversion &&
         source.type == dest.type) {
         CopyTextures(source, dest, copy);
@@ -304,6 +360,7 @@ bool TextureRuntime::Reinterpret(Surface& source, Surface& dest,
 }
 
 bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClear& clear) {
+    surface.ScaleLevels(clear.texture_level, 1);
     renderpass_cache.EndRendering();
 
     const RecordParams params = {
@@ -453,6 +510,10 @@ void TextureRuntime::ClearTextureWithRenderpass(Surface& surface,
 
 bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
                                   std::span<const VideoCore::TextureCopy> copies) {
+    for (const VideoCore::TextureCopy& copy : copies) {
+        source.ScaleLevels(copy.src_level, 1);
+        dest.ScaleLevels(copy.dst_level, 1);
+    }
     renderpass_cache.EndRendering();
 
     const RecordParams params = {
@@ -555,6 +616,9 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest,
 
 bool TextureRuntime::BlitTextures(Surface& source, Surface& dest,
                                   const VideoCore::TextureBlit& blit) {
+    source.ScaleLevels(blit.src_level, 1);
+    dest.ScaleLevels(blit.dst_level, 1);
+
     const bool is_depth_stencil = source.type == VideoCore::SurfaceType::DepthStencil;
     const auto& depth_traits = instance.GetTraits(source.pixel_format);
     if (is_depth_stencil && !depth_traits.blit_support) {
@@ -671,6 +735,10 @@ void TextureRuntime::GenerateMipmaps(Surface& surface) {
 
     renderpass_cache.EndRendering();
 
+    // Every mip level is overwritten from the base level, there is no need to scale them first.
+    surface.ScaleLevels(0, 1);
+    surface.pending_levels = 0;
+
     auto [width, height] = surface.RealExtent();
     const u32 levels = surface.levels;
     for (u32 i = 1; i < levels; i++) {
@@ -689,6 +757,82 @@ void TextureRuntime::GenerateMipmaps(Surface& surface) {
     }
 }
 
+bool TextureRuntime::ReserveScaledMemory(u64 size) {
+    const u64 budget = u64{Settings::values.scaled_textures_budget.GetValue()} * 1_MiB;
+    if (budget == 0) {
+        return true;
+    }
+    while (scaled_bytes + size > budget && !scaled_pool.empty()) {
+        EvictScaledHandle();
+    }
+    return scaled_bytes + size <= budget;
+}
+
+Handle TextureRuntime::AcquireScaledHandle(const ScaledImageKey& key, std::string_view debug_name,
+                                           bool enforce_budget) {
+    // Prefer the most recently recycled image, it is the most likely to be resident.
+    const auto it = std::find_if(scaled_pool.rbegin(), scaled_pool.rend(), [&](const auto& pooled) {
+        return pooled.key == key && scheduler.IsFree(pooled.tick);
+    });
+    if (it != scaled_pool.rend()) {
+        Handle handle = std::move(it->handle);
+        scaled_pool.erase(std::next(it).base());
+        if (!debug_name.empty() && instance.HasDebuggingToolAttached()) {
+            SetObjectName(instance.GetDevice(), handle.image, debug_name);
+        }
+        scale_stats.images_reused++;
+        return handle;
+    }
+
+    const u64 size = key.SizeBytes();
+    if (!ReserveScaledMemory(size) && enforce_budget) {
+        scale_stats.scales_rejected++;
+        return {};
+    }
+
+    scaled_bytes += size;
+    scale_stats.images_allocated++;
+    scale_stats.bytes_allocated += size;
+    return MakeHandle(&instance, key.width, key.height, key.levels, key.type, key.format, key.usage,
+                      key.flags, key.aspect, key.need_format_list, debug_name);
+}
+
+void TextureRuntime::RecycleScaledHandle(const ScaledImageKey& key, Handle&& handle, u64 tick) {
+    scaled_pool.push_back(PooledImage{
+        .key = key,
+        .handle = std::move(handle),
+        .tick = tick,
+    });
+    if (scaled_pool.size() > MAX_POOLED_SCALED_IMAGES) {
+        EvictScaledHandle();
+    }
+}
+
+void TextureRuntime::RetireResources(RetiredResources&& resources) {
+    ReleaseRetiredResources();
+    retired_resources.push_back(std::move(resources));
+}
+
+void TextureRuntime::ReleaseRetiredResources() {
+    while (!retired_resources.empty() && scheduler.IsFree(retired_resources.front().tick)) {
+        Handle& handle = retired_resources.front().handle;
+        if (handle.image) {
+            handle.image_view.reset();
+            vmaDestroyImage(instance.GetAllocator(), handle.image, handle.alloc);
+        }
+        retired_resources.pop_front();
+    }
+}
+
+void TextureRuntime::EvictScaledHandle() {
+    PooledImage& pooled = scaled_pool.front();
+    scheduler.Wait(pooled.tick);
+    pooled.handle.image_view.reset();
+    vmaDestroyImage(instance.GetAllocator(), pooled.handle.image, pooled.handle.alloc);
+    scaled_bytes -= pooled.key.SizeBytes();
+    scaled_pool.pop_front();
+}
+
 bool TextureRuntime::NeedsConversion(VideoCore::PixelFormat format) const {
     const FormatTraits traits = instance.GetTraits(format);
     return traits.needs_conversion &&
@@ -726,9 +870,8 @@ Surface::Surface(TextureRuntime& runtime_, const VideoCore::SurfaceParams& param
     raw_images.emplace_back(handles[0].image);
 
     if (res_scale != 1) {
-        handles[1] =
-            MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type, format,
-                       traits.usage, flags, traits.aspect, need_format_list, DebugName(true));
+        handles[1] = runtime->AcquireScaledHandle(MakeScaledKey(), DebugName(true), false);
+        is_scaled_pooled = true;
         raw_images.emplace_back(handles[1].image);
     }
 
@@ -793,6 +936,11 @@ Surface::~Surface() {
         return;
     }
     scheduler->Finish();
+    if (is_scaled_pooled) {
+        // The scheduler is idle so the image is free to be reused by the next submission.
+        runtime->RecycleScaledHandle(MakeScaledKey(), std::exchange(handles[1], {}),
+                                     scheduler->CurrentTick() - 1);
+    }
     for (const auto& [alloc, image, image_view] : handles) {
         if (image) {
             vmaDestroyImage(instance->GetAllocator(), image, alloc);
@@ -876,7 +1024,8 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload,
 
     runtime->upload_buffer.Commit(staging.size);
 
-    if (res_scale != 1) {
+    // Pending levels are scaled from the base image with the new data on first access.
+    if (res_scale != 1 && !(pending_levels & (1U << upload.texture_level))) {
         const VideoCore::TextureBlit blit = {
             .src_level = upload.texture_level,
             .dst_level = upload.texture_level,
@@ -980,7 +1129,7 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download,
         return;
     }
 
-    if (res_scale != 1) {
+    if (res_scale != 1 && !(pending_levels & (1U << download.texture_level))) {
         const VideoCore::TextureBlit blit = {
             .src_level = download.texture_level,
             .dst_level = download.texture_level,
@@ -1052,26 +1201,45 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download,
         });
 }
 
-void Surface::ScaleUp(u32 new_scale) {
+void Surface::ScaleUp(u32 new_scale, bool force) {
     if (res_scale == new_scale || new_scale == 1) {
         return;
     }
 
-    res_scale = new_scale;
-
-    const bool is_mutable = pixel_format == VideoCore::PixelFormat::RGBA8;
-
-    vk::ImageCreateFlags flags{};
-    if (texture_type == VideoCore::TextureType::CubeMap) {
-        flags |= vk::ImageCreateFlagBits::eCubeCompatible;
+    const ScaledImageKey old_key = MakeScaledKey();
+    const u32 old_scale = std::exchange(res_scale, new_scale);
+    Handle handle = runtime->AcquireScaledHandle(MakeScaledKey(), DebugName(true), !force);
+    if (!handle.image) {
+        // Out of budget, keep the surface at its current scale.
+        res_scale = old_scale;
+        return;
     }
-    if (is_mutable) {
-        flags |= vk::ImageCreateFlagBits::eMutableFormat;
+
+    // The cached views and the copy image were made for the previous image and size. They may
+    // still be used by pending work, so they are destroyed once the GPU is done with it.
+    if (depth_view || stencil_view || storage_view || framebuffers[1] || copy_handle.image) {
+        runtime->RetireResources({
+            .tick = scheduler->CurrentTick(),
+            .views = {std::move(depth_view), std::move(stencil_view), std::move(storage_view)},
+            .framebuffer = std::move(framebuffers[1]),
+            .handle = std::exchange(copy_handle, {}),
+        });
     }
 
-    handles[1] =
-        MakeHandle(instance, GetScaledWidth(), GetScaledHeight(), levels, texture_type,
-                   traits.native, traits.usage, flags, traits.aspect, false, DebugName(true));
+    if (is_scaled_pooled) {
+        runtime->RecycleScaledHandle(old_key, std::exchange(handles[1], {}),
+                                     scheduler->CurrentTick());
+    } else if (handles[1].image) {
+        // Custom texture images are not part of the upscaling budget.
+        runtime->RetireResources({
+            .tick = scheduler->CurrentTick(),
+            .views = {},
+            .framebuffer = {},
+            .handle = std::exchange(handles[1], {}),
+        });
+    }
+    handles[1] = std::move(handle);
+    is_scaled_pooled = true;
 
     runtime->renderpass_cache.EndRendering();
     scheduler->Record(
@@ -1082,13 +1250,32 @@ void Surface::ScaleUp(u32 new_scale) {
                                    vk::DependencyFlagBits::eByRegion, {}, {}, barriers);
         });
 
-    for (u32 level = 0; level < levels; level++) {
+    // Most surfaces promoted to a higher scale are render targets that never sample their mip
+    // levels, so only the base level is scaled up front.
+    pending_levels = (1U << levels) - 1;
+    ScaleLevels(0, 1);
+}
+
+void Surface::ScaleLevels(u32 level, u32 count) {
+    if (pending_levels == 0) {
+        return;
+    }
+
+    const u32 end = std::min(level + count, levels);
+    for (; level < end; level++) {
+        const u32 bit = 1U << level;
+        if (!(pending_levels & bit)) {
+            continue;
+        }
+        pending_levels &= ~bit;
+
         const VideoCore::TextureBlit blit = {
             .src_level = level,
             .dst_level = level,
             .src_rect = GetRect(level),
             .dst_rect = GetScaledRect(level),
         };
+        runtime->renderpass_cache.EndRendering();
         BlitScale(blit, true);
     }
 }
@@ -1139,6 +1326,8 @@ vk::Image Surface::Image(u32 index) const noexcept {
 }
 
 vk::ImageView Surface::CopyImageView() noexcept {
+    ScaleLevels();
+
     vk::ImageLayout copy_layout = vk::ImageLayout::eGeneral;
     if (!copy_handle.image) {
         vk::ImageCreateFlags flags{};
@@ -1353,6 +1542,7 @@ void Surface::BlitScale(const VideoCore::TextureBlit& blit, bool up_scale) {
         LOG_WARNING(Render_Vulkan, "Depth scale unsupported by hardware");
         return;
     }
+    runtime->scale_stats.blits++;
 
     scheduler->Record([src_image = Image(!up_scale), aspect = Aspect(),
                        filter = MakeFilter(pixel_format), dst_image = Image(up_scale),
@@ -1449,6 +1639,30 @@ void Surface::BlitScale(const VideoCore::TextureBlit& blit, bool up_scale) {
     });
 }
 
+ScaledImageKey Surface::MakeScaledKey() const noexcept {
+    const bool is_mutable = pixel_format == VideoCore::PixelFormat::RGBA8;
+
+    vk::ImageCreateFlags flags{};
+    if (texture_type == VideoCore::TextureType::CubeMap) {
+        flags |= vk::ImageCreateFlagBits::eCubeCompatible;
+    }
+    if (is_mutable) {
+        flags |= vk::ImageCreateFlagBits::eMutableFormat;
+    }
+
+    return ScaledImageKey{
+        .width = GetScaledWidth(),
+        .height = GetScaledHeight(),
+        .levels = levels,
+        .type = texture_type,
+        .format = traits.native,
+        .usage = traits.usage,
+        .flags = flags,
+        .aspect = traits.aspect,
+        .need_format_list = is_mutable && instance->IsImageFormatListSupported(),
+    };
+}
+
 Framebuffer::Framebuffer(TextureRuntime& runtime, const VideoCore::FramebufferParams& params,
                          Surface* color, Surface* depth)
     : VideoCore::FramebufferParams{params},
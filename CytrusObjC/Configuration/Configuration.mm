@@ -142,10 +142,13 @@ void Configuration::ReadValues() {
     ReadSetting("Renderer", Settings::values.graphics_api);
     ReadSetting("Renderer", Settings::values.async_presentation);
     ReadSetting("Renderer", Settings::values.async_shader_compilation);
+    ReadSetting("Renderer", Settings::values.gpu_texture_decoding);
+    ReadSetting("Renderer", Settings::values.async_gpu_emulation);
     ReadSetting("Renderer", Settings::values.spirv_shader_gen);
     ReadSetting("Renderer", Settings::values.use_hw_shader);
     ReadSetting("Renderer", Settings::values.use_shader_jit);
     ReadSetting("Renderer", Settings::values.resolution_factor);
+    ReadSetting("Renderer", Settings::values.scaled_textures_budget);
     ReadSetting("Renderer", Settings::values.use_disk_shader_cache);
     ReadSetting("Renderer", Settings::values.use_vsync_new);
     ReadSetting("Renderer", Settings::values.texture_filter);
@@ -195,6 +198,7 @@ void Configuration::ReadValues() {
     ReadSetting("Utility", Settings::values.custom_textures);
     ReadSetting("Utility", Settings::values.preload_textures);
     ReadSetting("Utility", Settings::values.async_custom_loading);
+    ReadSetting("Utility", Settings::values.custom_textures_budget);
 
     // Audio
     ReadSetting("Audio", Settings::values.audio_emulation);
@@ -259,6 +263,7 @@ void Configuration::ReadValues() {
     // Debugging
     Settings::values.record_frame_times =
         sdl2_config->GetBoolean("Debugging", "record_frame_times", false);
+    ReadSetting("Debugging", Settings::values.record_trace);
     ReadSetting("Debugging", Settings::values.renderer_debug);
     ReadSetting("Debugging", Settings::values.use_gdbstub);
     ReadSetting("Debugging", Settings::values.gdbstub_port);
@@ -109,6 +109,14 @@ graphics_api =
 # 0: Off, 1: On (default)
 async_shader_compilation =
 
+# Whether to decode guest textures with a compute shader instead of on the CPU (Vulkan only)
+# 0 (default): Off, 1: On
+gpu_texture_decoding =
+
+# Whether to process GPU commands on a separate thread instead of the emulation thread
+# 0 (default): Off, 1: On
+async_gpu_emulation =
+
 # Whether to emit PICA fragment shader using SPIRV or GLSL (Vulkan only)
 # 0: GLSL, 1: SPIR-V (default)
 spirv_shader_gen =
@@ -139,6 +147,10 @@ use_disk_shader_cache =
 # factor for the 3DS resolution
 resolution_factor =
 
+# VRAM budget of the upscaled textures. Textures stay at native resolution when it is exhausted
+# 0 (default): Unlimited, otherwise the budget in MiB
+scaled_textures_budget =
+
 # Whether to enable V-Sync (caps the framerate at 60FPS) or not.
 # 0 (default): Off, 1: On
 vsync_enabled =
@@ -228,6 +240,11 @@ preload_textures =
 # 0: Off, 1 (default): On
 async_custom_loading =
 
+# Maximum memory in MiB used by decoded custom textures. The least recently used textures are
+# evicted and loaded again when needed.
+# 0 (default): Automatic, otherwise the budget in MiB
+custom_textures_budget =
+
 [Audio]
 # Whether or not to enable DSP LLE
 # 0 (default): No, 1: Yes
@@ -349,6 +366,10 @@ log_filter = *:Info
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
 
+# Record a timeline trace of the profiling scopes, can be found in the log directory as a Chrome
+# trace event file. Boolean value
+record_trace =
+
 # Whether to enable additional debugging information during emulation
 # 0 (default): Off, 1: On
 renderer_debug =
@@ -35,6 +35,7 @@
 #include "core/loader/loader.h"
 #include "core/loader/smdh.h"
 #include "network/network_settings.h"
+#include "video_core/custom_textures/custom_tex_manager.h"
 #include "video_core/gpu.h"
 #include "video_core/renderer_base.h"
 
@@ -300,6 +300,9 @@ static void TryShutdown() {
     
     std::unique_ptr<Frontend::GraphicsContext> cpu_context;
     system.GPU().Renderer().Rasterizer()->LoadDiskResources(stop_run, [](VideoCore::LoadCallbackStage, std::size_t, std::size_t) {});
+    if (Settings::values.custom_textures && Settings::values.preload_textures) {
+        system.CustomTexManager().PreloadTextures(stop_run, [](VideoCore::LoadCallbackStage, std::size_t, std::size_t) {});
+    }
     
     SCOPE_EXIT({
         TryShutdown();